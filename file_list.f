@@ -6,8 +6,11 @@
 ./src/core_part/N2_exec.sv
 ./src/core_part/N2_lsu.sv
 ./src/core_part/N2_mu.sv
+./src/core_part/N2_hpm.sv
+./src/core_part/N2_rf_lvt.sv
 ./src/core_part/NanoCore.sv
 ./src/core_part/N2_idu_predecode.sv
+./src/core_part/N2_idu_rvc.sv
 ./src/core_part/Irq_Calc_Offset.sv
 ./src/core_part/NanoCore_Wrapper.sv
 ./src/mem_part/Memory_Top_2Port.sv
@@ -17,6 +20,8 @@
 # ./src/mem_part/Cache/NanoCache_Search.sv
 # ./src/mem_part/Cache/NanoCache_Update.sv
 ./src/mem_part/Cache/NanoCache_Search_1PE.sv
+./src/mem_part/Cache/NanoCache_Search_SA.sv
+./src/mem_part/Cache/NanoCache_WCB.sv
 ./src/mem_part/Cache/NanoCache_Update_1PE.sv
 
 ./src/peripherals_part/Peri_Top.sv
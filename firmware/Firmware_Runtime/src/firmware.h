@@ -49,6 +49,9 @@
 //*     0x10040040                                                                //
 //*         -0x1004005c: shared registers;                                        //
 //*     0x1004007C: x ns/clk, e.g., 20 ns/clk in 50MHz                            //
+//*     0x10040080                                                                //
+//*         -0x100400bc: hpm counters of PE0 (r), low/high 32b of cycle,          //
+//*                      instret, mhpmcounter3, mhpmcounter4, ...;                //
 //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<//
 #define TIMER_NS_ADDR               0x10040030  //* system timer address, ns;
 #define TIMER_S_ADDR                0x10040034  //* system timer address, s;
@@ -81,6 +84,27 @@
 
 #define CSR_NS_PER_CLK              0x1004007C
 
+//* hpm counters (mirror of mcycle/minstret/mhpmcounter3~, read-only);
+#define CSR_HPM_CYCLE_LOW_ADDR      0x10040080
+#define CSR_HPM_CYCLE_HIGH_ADDR     0x10040084
+#define CSR_HPM_INSTRET_LOW_ADDR    0x10040088
+#define CSR_HPM_INSTRET_HIGH_ADDR   0x1004008c
+#define CSR_HPM_CNT_LOW_ADDR(n)     (0x10040090 + ((n)-3)*8)  //* n is 3~
+#define CSR_HPM_CNT_HIGH_ADDR(n)    (0x10040094 + ((n)-3)*8)
+
+//* hpm event id, written to mhpmevent3~ (csr 0x323~), '0' is off;
+#define HPM_EVT_BR_MISS             1   //* branch/jalr mispredict
+#define HPM_EVT_JAL_MISS            2   //* jal/backward branch missed in btb
+#define HPM_EVT_IC_MISS             3   //* icache miss
+#define HPM_EVT_DC_MISS             4   //* dcache read miss
+#define HPM_EVT_LSQ_FULL            5   //* clks lsq is full
+#define HPM_EVT_MU_BUSY             6   //* clks mul/div is in flight
+#define HPM_EVT_ISSUE0              7   //* clks no instr is issued
+#define HPM_EVT_ISSUE1              8   //* clks only one instr is issued
+#define HPM_EVT_ISSUE2              9   //* clks two instrs are issued
+#define HPM_EVT_IRQ                 10  //* irq taken
+#define HPM_EVT_IRQ_CLK             11  //* clks in irq handler, /HPM_EVT_IRQ is latency per irq
+
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 //* 0x1007xxxx is left for DMA                                                    //
 //*     0x10070000: irq_info (r), '0x80000000' is empty;                          //
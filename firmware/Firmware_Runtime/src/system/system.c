@@ -42,6 +42,150 @@ void print_hex(unsigned int val, int digits){
 }
 void print_void(void){}
 
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+//*     crc32 & flow hash with Zbc (need ENABLE_ZBC in hardware); //
+//*         1) barrett reduction, 4B per step: 1 clmul + 1 clmulr;//
+//*         2) tail bytes use the same step with a shifted byte;  //
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<//
+#define CRC32_POLY_REV  0xedb88320  //* reflected poly
+#define CRC32_MU_REV    0xfb808b20  //* reflected (x^64 / poly) without x^32
+
+static inline uint32_t clmul(uint32_t a, uint32_t b){
+  uint32_t r;
+  __asm__ ("clmul %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+  return r;
+}
+static inline uint32_t clmulr(uint32_t a, uint32_t b){
+  uint32_t r;
+  __asm__ ("clmulr %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+  return r;
+}
+//* fold one 32b word (little-endian) into crc;
+static inline uint32_t crc32_word(uint32_t crc, uint32_t w){
+  uint32_t s = crc ^ w;
+  uint32_t t = (clmul(s, CRC32_MU_REV) << 1) ^ s;
+  return clmulr(t, CRC32_POLY_REV);
+}
+
+//* crc = 0 to start, the returned crc can be passed in to continue;
+uint32_t crc32_clmul(uint32_t crc, const void *buf, int len){
+  const uint8_t *p = (const uint8_t *)buf;
+  crc = ~crc;
+  while (len > 0 && ((uintptr_t)p & 3)) {
+    crc = (crc >> 8) ^ crc32_word(0, ((crc ^ *p++) & 0xff) << 24);
+    len--;
+  }
+  while (len > 3) {
+    crc = crc32_word(crc, *(const uint32_t *)p);
+    p += 4;
+    len -= 4;
+  }
+  while (len > 0) {
+    crc = (crc >> 8) ^ crc32_word(0, ((crc ^ *p++) & 0xff) << 24);
+    len--;
+  }
+  return ~crc;
+}
+
+//* 5-tuple in host order, e.g., used to select rx queue/core;
+uint32_t flow_hash(uint32_t sip, uint32_t dip, uint16_t sport,
+                   uint16_t dport, uint8_t proto){
+  uint32_t crc = 0xffffffff;
+  crc = crc32_word(crc, sip);
+  crc = crc32_word(crc, dip);
+  crc = crc32_word(crc, ((uint32_t)sport << 16) | dport);
+  crc = crc32_word(crc, proto);
+  return ~crc;
+}
+
+//* spinlock, test-and-test-and-set;
+void spin_lock(spinlock_t *l){
+  while (__atomic_exchange_n(&l->lock, 1, __ATOMIC_ACQUIRE))
+    while (l->lock);
+}
+//* return 1 if the lock is taken;
+int spin_trylock(spinlock_t *l){
+  return __atomic_exchange_n(&l->lock, 1, __ATOMIC_ACQUIRE) == 0;
+}
+void spin_unlock(spinlock_t *l){
+  __atomic_store_n(&l->lock, 0, __ATOMIC_RELEASE);
+}
+
+//* spsc ring, head/tail are free-running, return 0 if full/empty;
+void spsc_init(spsc_ring_t *r, void **buf, uint32_t size){
+  r->head = 0;
+  r->tail = 0;
+  r->mask = size - 1;
+  r->buf  = buf;
+}
+int spsc_enqueue(spsc_ring_t *r, void *data){
+  uint32_t tail = r->tail;
+  if (tail - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) > r->mask)
+    return 0;
+  r->buf[tail & r->mask] = data;
+  __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+  return 1;
+}
+int spsc_dequeue(spsc_ring_t *r, void **data){
+  uint32_t head = r->head;
+  if (head == __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE))
+    return 0;
+  *data = r->buf[head & r->mask];
+  __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+  return 1;
+}
+
+//* mpmc ring, each cell has a seq: seq == pos means free for enqueue,
+//*   seq == pos + 1 means ready for dequeue, pos is claimed by lr/sc (cas);
+void mpmc_init(mpmc_ring_t *r, mpmc_cell_t *buf, uint32_t size){
+  for (uint32_t i = 0; i < size; i++)
+    buf[i].seq = i;
+  r->enq_pos = 0;
+  r->deq_pos = 0;
+  r->mask    = size - 1;
+  r->buf     = buf;
+}
+int mpmc_enqueue(mpmc_ring_t *r, void *data){
+  mpmc_cell_t *cell;
+  uint32_t pos = __atomic_load_n(&r->enq_pos, __ATOMIC_RELAXED);
+  for (;;) {
+    cell = &r->buf[pos & r->mask];
+    int32_t dif = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+    if (dif == 0) {
+      if (__atomic_compare_exchange_n(&r->enq_pos, &pos, pos + 1, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        break;
+    }
+    else if (dif < 0)
+      return 0;
+    else
+      pos = __atomic_load_n(&r->enq_pos, __ATOMIC_RELAXED);
+  }
+  cell->data = data;
+  __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+  return 1;
+}
+int mpmc_dequeue(mpmc_ring_t *r, void **data){
+  mpmc_cell_t *cell;
+  uint32_t pos = __atomic_load_n(&r->deq_pos, __ATOMIC_RELAXED);
+  for (;;) {
+    cell = &r->buf[pos & r->mask];
+    int32_t dif = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+    if (dif == 0) {
+      if (__atomic_compare_exchange_n(&r->deq_pos, &pos, pos + 1, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        break;
+    }
+    else if (dif < 0)
+      return 0;
+    else
+      pos = __atomic_load_n(&r->deq_pos, __ATOMIC_RELAXED);
+  }
+  *data = cell->data;
+  __atomic_store_n(&cell->seq, pos + r->mask + 1, __ATOMIC_RELEASE);
+  return 1;
+}
+
 #define PAD_RIGHT 1
 #define PAD_ZERO 2
 static int print(const char *format, va_list args ){
@@ -22,6 +22,78 @@ void print_hex(unsigned int val, int digits);
 int  printf(const char *format, ...);
 void print_void(void);
 
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+//*     crc32 & flow hash (Zbc clmul/clmulr);  //
+//*         1) crc32 (IEEE, same as zlib);     //
+//*         2) hash of ipv4 5-tuple (crc32);   //
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<//
+uint32_t crc32_clmul(uint32_t crc, const void *buf, int len);
+uint32_t flow_hash(uint32_t sip, uint32_t dip, uint16_t sport,
+                   uint16_t dport, uint8_t proto);
+
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+//*     hardware loop (lp.*, ENABLE_HWLOOP);   //
+//*         1) level 0 is the inner loop;      //
+//*         2) last instr of body is not a     //
+//*            branch/jump, no label "9";      //
+//*         3) not used in irq handler;        //
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<//
+//* body runs cnt times (rs is the number of the register holding cnt), e.g.,
+//*   register uint32_t cnt asm("t0") = n;
+//*   __asm__ volatile(LP_BEGIN(0, 5)
+//*                    "lw   a5, 0(%[p])\n\t"
+//*                    "addi %[p], %[p], 4\n\t"
+//*                    "add  %[s], %[s], a5"
+//*                    LP_END
+//*                    : [s]"+r"(sum), [p]"+r"(p) : "r"(cnt) : "a5", "memory");
+#define LP_BEGIN(_l, _rs) \
+  ".option push\n\t.option norelax\n\t" \
+  ".word ((((9f - .) >> 1) << 20) | (" #_rs " << 15) | (4 << 12) | (" #_l " << 7) | 0x7b)\n\t"
+//* the same as LP_BEGIN, cnt is an immediate (< 4096) and body is < 64B;
+#define LP_BEGINI(_l, _cnt) \
+  ".option push\n\t.option norelax\n\t" \
+  ".word (((" #_cnt " & 0xfff) << 20) | (((9f - .) >> 1) << 15) | (5 << 12) | (" #_l " << 7) | 0x7b)\n\t"
+#define LP_END \
+  "\n9:\n\t.option pop\n\t"
+
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+//*     lock & queue (RV32A, ENABLE_ATOMIC);   //
+//*         1) spinlock (amoswap.w);           //
+//*         2) spsc ring, 1 producer/consumer; //
+//*         3) mpmc ring, per-slot sequence;   //
+//*         size of ring is a power of 2;      //
+//<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<//
+typedef struct {
+  volatile uint32_t lock;
+} spinlock_t;
+void spin_lock(spinlock_t *l);
+int  spin_trylock(spinlock_t *l);
+void spin_unlock(spinlock_t *l);
+
+typedef struct {
+  volatile uint32_t head;     //* written by consumer;
+  volatile uint32_t tail;     //* written by producer;
+  uint32_t          mask;
+  void            **buf;
+} spsc_ring_t;
+void spsc_init(spsc_ring_t *r, void **buf, uint32_t size);
+int  spsc_enqueue(spsc_ring_t *r, void *data);
+int  spsc_dequeue(spsc_ring_t *r, void **data);
+
+typedef struct {
+  volatile uint32_t seq;
+  void             *data;
+} mpmc_cell_t;
+typedef struct {
+  volatile uint32_t enq_pos;
+  volatile uint32_t deq_pos;
+  uint32_t          mask;
+  mpmc_cell_t      *buf;
+} mpmc_ring_t;
+void mpmc_init(mpmc_ring_t *r, mpmc_cell_t *buf, uint32_t size);
+int  mpmc_enqueue(mpmc_ring_t *r, void *data);
+int  mpmc_dequeue(mpmc_ring_t *r, void **data);
+
 // //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 // //*     sys_gettime, i.e., gettimeofday        //
 // //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<//
@@ -0,0 +1,79 @@
+/*
+ * lwIP checksum with NanoCore's custom instrs (LWIP_CHKSUM = riscv_chksum):
+ *   csum.add  rd, rs1, rs2: rd = rs1 + rs2, carry is added back;
+ *   csum.fold rd, rs1     : fold 32b ones-complement sum to 16b;
+ * encoded in custom-0 (see custom_ops.S), need ENABLE_XCSUM in hardware.
+ */
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/inet_chksum.h"
+
+#if LWIP_CHKSUM_HW
+
+#define CSUM_ADD(acc, w) \
+  __asm__ (".insn r 0x0b, 0, 0x08, %0, %1, %2" : "=r"(acc) : "r"(acc), "r"(w))
+#define CSUM_FOLD(acc) \
+  __asm__ (".insn r 0x0b, 0, 0x09, %0, %1, x0" : "=r"(acc) : "r"(acc))
+
+/**
+ * Same result as lwip_standard_chksum (algorithm 3), 4 bytes per csum.add;
+ * two accumulators are used so that adjacent csum.add can be dual-issued.
+ *
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+u16_t
+riscv_chksum(const void *dataptr, int len)
+{
+  const u8_t *pb = (const u8_t *)dataptr;
+  const u32_t *pl;
+  u32_t sum0 = 0, sum1 = 0, t = 0;
+  /* starts at odd byte address? */
+  int odd = ((mem_ptr_t)pb & 1);
+
+  if (odd && len > 0) {
+    ((u8_t *)&t)[1] = *pb++;
+    len--;
+  }
+  if (((mem_ptr_t)pb & 2) && len > 1) {
+    t += *(const u16_t *)(const void *)pb;
+    pb += 2;
+    len -= 2;
+  }
+
+  pl = (const u32_t *)(const void *)pb;
+  while (len > 15) {
+    CSUM_ADD(sum0, pl[0]);
+    CSUM_ADD(sum1, pl[1]);
+    CSUM_ADD(sum0, pl[2]);
+    CSUM_ADD(sum1, pl[3]);
+    pl += 4;
+    len -= 16;
+  }
+  while (len > 3) {
+    CSUM_ADD(sum0, *pl++);
+    len -= 4;
+  }
+
+  /* 16-bit word & dangling tail byte remaining? */
+  pb = (const u8_t *)pl;
+  if (len > 1) {
+    t += *(const u16_t *)(const void *)pb;
+    pb += 2;
+    len -= 2;
+  }
+  if (len > 0) {
+    t += *pb;
+  }
+
+  CSUM_ADD(sum0, sum1);
+  CSUM_ADD(sum0, t);
+  CSUM_FOLD(sum0);
+
+  if (odd) {
+    sum0 = SWAP_BYTES_IN_WORD(sum0);
+  }
+
+  return (u16_t)sum0;
+}
+
+#endif /* LWIP_CHKSUM_HW */
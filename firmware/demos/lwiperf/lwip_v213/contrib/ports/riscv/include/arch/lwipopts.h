@@ -81,6 +81,12 @@
 #define IP_FRAG_MAX_MTU 1500
 #define IP_DEFAULT_TTL 255
 #define LWIP_CHKSUM_ALGORITHM 3
+//* use csum.add/csum.fold (ENABLE_XCSUM), see contrib/ports/riscv/chksum.c;
+#define LWIP_CHKSUM_HW 1
+#if LWIP_CHKSUM_HW
+#define LWIP_CHKSUM riscv_chksum
+unsigned short riscv_chksum(const void *dataptr, int len);
+#endif
 
 #define LWIP_UDP 1
 #define UDP_TTL 255
@@ -17,6 +17,11 @@ void main(void){
     //* test isa;
     __TEST_RV32UI_ISA();
     __TEST_RV32UM_ISA();
+    __TEST_RV32UC_ISA();
+    __TEST_RV32UZBA_ISA();
+    __TEST_RV32UZBB_ISA();
+    __TEST_RV32UZBC_ISA();
+    __TEST_RV32UA_ISA();
     printf("ISA test is pased\r\n");
     while(1);
 }
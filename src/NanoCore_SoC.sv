@@ -122,6 +122,10 @@ module NanoCore_SoC(
   wire  [           255:0]  w_dma_rdata;        //* return read result from data SRAM;
   wire                      w_dma_rvalid;
   wire                      w_dma_gnt;          //* allow to read/write next data;
+`ifdef ENABLE_HPM
+  //* 8) hpm counters of PE0: MultiCore ---> CSR;
+  wire  [(`HPM_NUM+2)*64-1:0] w_hpm_cnt;
+`endif
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
 `ifdef ENABLE_DRA
@@ -193,6 +197,9 @@ module NanoCore_SoC(
     .o_dma_rdata            (w_dma_rdata                  ),
     .o_dma_rvalid           (w_dma_rvalid                 ),
     .o_dma_gnt              (w_dma_gnt                    )
+  `ifdef ENABLE_HPM
+    ,.o_hpm_cnt             (w_hpm_cnt                    )
+  `endif
   );
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
@@ -230,6 +237,9 @@ module NanoCore_SoC(
     .o_irq                  (w_irq_bitmap                 ),
     .i_irq_ack              (w_irq_ack                    ),
     .i_irq_id               (w_irq_id                     )
+  `ifdef ENABLE_HPM
+    ,.i_hpm_cnt             (w_hpm_cnt                    )
+  `endif
   `ifdef UART_BY_PKT
     ,.o_uartPkt_valid       (w_uartPkt_valid              )
     ,.o_uartPkt             (w_uartPkt                    )
@@ -78,6 +78,10 @@ module MultiCore_Top(
   ,output   wire  [           255:0]  o_dma_rdata
   ,output   wire                      o_dma_rvalid
   ,output   wire                      o_dma_gnt           //* allow next access;
+`ifdef ENABLE_HPM
+  //* hpm counters of PE0, {mhpmcounter3~, instret, cycle};
+  ,output   wire  [(`HPM_NUM+2)*64-1:0] o_hpm_cnt
+`endif
 );
 
   //====================================================================//
@@ -91,15 +95,22 @@ module MultiCore_Top(
   wire  [`NUM_PE-1:0][31:0] w_data_addr;
   wire  [`NUM_PE-1:0][ 3:0] w_data_wstrb;
   wire  [`NUM_PE-1:0][31:0] w_data_wdata;
+  wire  [`NUM_PE-1:0]       w_data_amo;
+  wire  [`NUM_PE-1:0][ 4:0] w_data_amo_op;
   wire  [`NUM_PE-1:0]       w_data_valid;
   wire  [`NUM_PE-1:0][31:0] w_data_rdata;
   wire  [`NUM_PE-1:0]       w_instr_req;
   wire  [`NUM_PE-1:0][ 1:0] w_instr_req_2b;
   wire  [`NUM_PE-1:0]       w_instr_gnt;
   wire  [`NUM_PE-1:0][31:0] w_instr_addr;
+  wire  [`NUM_PE-1:0]       w_instr_prefetch_req;
+  wire  [`NUM_PE-1:0][31:0] w_instr_prefetch_addr;
   wire  [`NUM_PE-1:0][ 1:0] w_instr_valid;
   wire  [`NUM_PE-1:0][63:0] w_instr_rdata;
   wire  [`NUM_PE-1:0]       w_flush;
+  wire                      w_miss_instr, w_miss_data;
+  wire  [`NUM_PE-1:0]       w_data_fence;
+  wire                      w_data_wcb_empty;
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
   //====================================================================//
@@ -125,6 +136,10 @@ module MultiCore_Top(
           .data_addr_o        (w_data_addr[i_pe]            ),
           .data_wstrb_o       (w_data_wstrb[i_pe]           ),
           .data_wdata_o       (w_data_wdata[i_pe]           ),
+          .data_amo_o         (w_data_amo[i_pe]             ),
+          .data_amo_op_o      (w_data_amo_op[i_pe]          ),
+          .data_fence_o       (w_data_fence[i_pe]           ),
+          .data_wcb_empty_i   (w_data_wcb_empty             ),
           .data_valid_ns_i    ('0        ),
           .data_valid_i       (w_data_valid[i_pe]           ),
           .data_rdata_i       (w_data_rdata[i_pe]           ),
@@ -132,6 +147,8 @@ module MultiCore_Top(
           .instr_req_o        (w_instr_req[i_pe]            ),
           .instr_req_2b_o     (w_instr_req_2b[i_pe]         ),
           .instr_addr_o       (w_instr_addr[i_pe]           ),
+          .instr_prefetch_req_o (w_instr_prefetch_req[i_pe] ),
+          .instr_prefetch_addr_o(w_instr_prefetch_addr[i_pe]),
           .instr_valid_i      (w_instr_valid[i_pe]          ),
           .instr_rdata_i      (w_instr_rdata[i_pe]          ),
           //* peri access interface;
@@ -147,6 +164,12 @@ module MultiCore_Top(
           .i_irq_bitmap       (i_irq_bitmap                 ),
           .o_irq_ack          (o_irq_ack                    ),
           .o_irq_id           (o_irq_id                     )
+        `ifdef ENABLE_HPM
+          //* hpm interface;
+          ,.i_miss_instr      (w_miss_instr                 ),
+          .i_miss_data        (w_miss_data                  ),
+          .o_hpm_cnt          (o_hpm_cnt                    )
+        `endif
         `ifdef ENABLE_DRA  
           //* DRA interface;
           ,.o_reg_rd          (o_reg_rd[i_pe]               ),
@@ -179,6 +202,10 @@ module MultiCore_Top(
           .data_addr_o        (w_data_addr[i_pe]            ),
           .data_wstrb_o       (w_data_wstrb[i_pe]           ),
           .data_wdata_o       (w_data_wdata[i_pe]           ),
+          .data_amo_o         (w_data_amo[i_pe]             ),
+          .data_amo_op_o      (w_data_amo_op[i_pe]          ),
+          .data_fence_o       (w_data_fence[i_pe]           ),
+          .data_wcb_empty_i   (w_data_wcb_empty             ),
           .data_valid_ns_i    ('0        ),
           .data_valid_i       (w_data_valid[i_pe]           ),
           .data_rdata_i       (w_data_rdata[i_pe]           ),
@@ -186,6 +213,8 @@ module MultiCore_Top(
           .instr_req_o        (w_instr_req[i_pe]            ),
           .instr_req_2b_o     (w_instr_req_2b[i_pe]         ),
           .instr_addr_o       (w_instr_addr[i_pe]           ),
+          .instr_prefetch_req_o (w_instr_prefetch_req[i_pe] ),
+          .instr_prefetch_addr_o(w_instr_prefetch_addr[i_pe]),
           .instr_valid_i      (w_instr_valid[i_pe]          ),
           .instr_rdata_i      (w_instr_rdata[i_pe]          ),
           //* peri access interface;
@@ -194,6 +223,12 @@ module MultiCore_Top(
           .i_peri_gnt         ('b0                          ),
           //* irq interface;
           .i_irq_bitmap       ('b0                          )
+        `ifdef ENABLE_HPM
+          //* hpm interface;
+          ,.i_miss_instr      ('b0                          ),
+          .i_miss_data        ('b0                          ),
+          .o_hpm_cnt          (                             )
+        `endif
         `ifdef ENABLE_DRA  
           //* DRA interface;
           ,.o_reg_rd          (o_reg_rd[i_pe]               ),
@@ -238,12 +273,18 @@ module MultiCore_Top(
     .i_data_addr            (w_data_addr                  ),
     .i_data_wstrb           (w_data_wstrb                 ),
     .i_data_wdata           (w_data_wdata                 ),
+    .i_data_amo             (w_data_amo                   ),
+    .i_data_amo_op          (w_data_amo_op                ),
+    .i_data_fence           (|w_data_fence                ),
+    .o_data_wcb_empty       (w_data_wcb_empty             ),
     .o_data_valid           (w_data_valid                 ),
     .o_data_rdata           (w_data_rdata                 ),
     .o_instr_gnt            (w_instr_gnt                  ),
     .i_instr_req            (w_instr_req                  ),
     .i_instr_req_2b         (w_instr_req_2b               ),
     .i_instr_addr           (w_instr_addr                 ),
+    .i_instr_prefetch_req   (w_instr_prefetch_req         ),
+    .i_instr_prefetch_addr  (w_instr_prefetch_addr        ),
     .o_instr_valid          (w_instr_valid                ),
     .o_instr_rdata          (w_instr_rdata                ),
     //* DMA interface;
@@ -256,6 +297,11 @@ module MultiCore_Top(
     .o_dma_rdata            (o_dma_rdata                  ),
     .o_dma_rvalid           (o_dma_rvalid                 ),
     .o_dma_gnt              (o_dma_gnt                    )
+  `ifdef ENABLE_HPM
+    //* hpm interface;
+    ,.o_miss_instr          (w_miss_instr                 ),
+    .o_miss_data            (w_miss_data                  )
+  `endif
   );
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
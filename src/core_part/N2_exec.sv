@@ -26,6 +26,11 @@ module N2_exec (
   output  reg           btb_upd_v_o,
   output  btb_t         btb_upd_info_o,
   input   btb_ctl_t     btb_ctl_i,
+  output  ras_fix_t     ras_fix_o,
+  `ifdef ENABLE_BHT
+  output  reg           bht_upd_v_o,
+  output  bht_upd_t     bht_upd_o,
+  `endif
 `endif
 
   input   wire  [31:0]  cur_pc_d2_i,
@@ -36,6 +41,8 @@ module N2_exec (
   wire [31:0] decoded_imm = uop_ctl_i.decoded_imm;
   wire        is_beq_bne_blt_bge_bltu_bgeu = uop_ctl_i.is_beq_bne_blt_bge_bltu_bgeu;
   wire        instr_jalr = uop_ctl_i.instr_jalr;
+  //* pc of next sequential instr;
+  wire [31:0] nxt_pc = cur_pc_d2_i + (uop_ctl_i.is_rvc? 32'd2: 32'd4);
   wire        instr_sub = uop_ctl_i.instr_sub;
   wire        instr_sra = uop_ctl_i.instr_sra;
   wire        instr_srai = uop_ctl_i.instr_srai;
@@ -74,6 +81,57 @@ module N2_exec (
     alu_shr = $signed({instr_sra || instr_srai ? alu_op1_i[31] : 1'b0, alu_op1_i}) >>> alu_op2_i[4:0];
   end
 
+`ifdef ENABLE_ZB
+  //* Zba/Zbb;
+  reg [31:0] alu_zb;
+  reg [5:0]  alu_clz, alu_ctz, alu_cpop;
+  always_comb begin
+    alu_clz   = 6'd32;
+    alu_ctz   = 6'd32;
+    alu_cpop  = '0;
+    for(integer i=0; i<32; i=i+1) begin
+      if(alu_op1_i[i])    alu_clz = 6'(31 - i);
+      if(alu_op1_i[31-i]) alu_ctz = 6'(31 - i);
+      alu_cpop  = alu_cpop + alu_op1_i[i];
+    end
+
+    alu_zb = 'bx;
+    (* parallel_case, full_case *)
+    case (1'b1)
+      uop_ctl_i.instr_sh1add: alu_zb = {alu_op1_i[30:0],1'b0} + alu_op2_i;
+      uop_ctl_i.instr_sh2add: alu_zb = {alu_op1_i[29:0],2'b0} + alu_op2_i;
+      uop_ctl_i.instr_sh3add: alu_zb = {alu_op1_i[28:0],3'b0} + alu_op2_i;
+      uop_ctl_i.instr_andn:   alu_zb = alu_op1_i & ~alu_op2_i;
+      uop_ctl_i.instr_orn:    alu_zb = alu_op1_i | ~alu_op2_i;
+      uop_ctl_i.instr_xnor:   alu_zb = ~(alu_op1_i ^ alu_op2_i);
+      uop_ctl_i.instr_clz:    alu_zb = {26'b0, alu_clz};
+      uop_ctl_i.instr_ctz:    alu_zb = {26'b0, alu_ctz};
+      uop_ctl_i.instr_cpop:   alu_zb = {26'b0, alu_cpop};
+      uop_ctl_i.instr_min:    alu_zb = alu_lts? alu_op1_i: alu_op2_i;
+      uop_ctl_i.instr_minu:   alu_zb = alu_ltu? alu_op1_i: alu_op2_i;
+      uop_ctl_i.instr_max:    alu_zb = alu_lts? alu_op2_i: alu_op1_i;
+      uop_ctl_i.instr_maxu:   alu_zb = alu_ltu? alu_op2_i: alu_op1_i;
+      uop_ctl_i.instr_rol:    alu_zb = alu_shl | (alu_op1_i >> (6'd32 - alu_op2_i[4:0]));
+      uop_ctl_i.instr_ror:    alu_zb = (alu_op1_i >> alu_op2_i[4:0]) | 
+                                       (alu_op1_i << (6'd32 - alu_op2_i[4:0]));
+      uop_ctl_i.instr_sext_b: alu_zb = {{24{alu_op1_i[7]}}, alu_op1_i[7:0]};
+      uop_ctl_i.instr_sext_h: alu_zb = {{16{alu_op1_i[15]}}, alu_op1_i[15:0]};
+      uop_ctl_i.instr_zext_h: alu_zb = {16'b0, alu_op1_i[15:0]};
+      uop_ctl_i.instr_rev8:   alu_zb = {alu_op1_i[7:0], alu_op1_i[15:8], alu_op1_i[23:16], alu_op1_i[31:24]};
+      uop_ctl_i.instr_orc_b:  alu_zb = {{8{|alu_op1_i[31:24]}}, {8{|alu_op1_i[23:16]}}, 
+                                        {8{|alu_op1_i[15:8]}},  {8{|alu_op1_i[7:0]}}};
+    endcase
+  end
+`endif
+
+`ifdef ENABLE_XCSUM
+  //* ones-complement sum, carry of rs1+rs2 is added back (can not carry again);
+  wire [32:0] csum_add  = {1'b0, alu_op1_i} + {1'b0, alu_op2_i};
+  wire [16:0] csum_half = {1'b0, alu_op1_i[31:16]} + {1'b0, alu_op1_i[15:0]};
+  wire [31:0] alu_csum  = uop_ctl_i.instr_csum_add? (csum_add[31:0] + {31'b0, csum_add[32]}):
+                                                    {16'b0, csum_half[15:0] + {15'b0, csum_half[16]}};
+`endif
+
   always_comb begin
     alu_out_0 = 'bx;
     (* parallel_case, full_case *)
@@ -95,6 +153,14 @@ module N2_exec (
     alu_out = 'bx;
     (* parallel_case, full_case *)
     case (1'b1)
+    `ifdef ENABLE_ZB
+      uop_ctl_i.is_zb:
+        alu_out = alu_zb;
+    `endif
+    `ifdef ENABLE_XCSUM
+      uop_ctl_i.is_csum:
+        alu_out = alu_csum;
+    `endif
       is_lui_auipc_jal_jalr_addi_add_sub:
         alu_out = alu_add_sub;
       is_compare:
@@ -131,7 +197,7 @@ module N2_exec (
         rf_dst_ex_o     <= 0;
         `ifdef ENABLE_BP
           is_branch_ex_o  <= alu_out_0 ^ btb_ctl_i.jump;
-          branch_pc_ex_o  <= alu_out_0? (cur_pc_d2_i + decoded_imm): (cur_pc_d2_i + 4);
+          branch_pc_ex_o  <= alu_out_0? (cur_pc_d2_i + decoded_imm): nxt_pc;
         `else
           is_branch_ex_o  <= alu_out_0;
         `endif
@@ -139,8 +205,9 @@ module N2_exec (
       else if(instr_jalr) begin
         is_branch_ex_o  <= ~btb_ctl_i.jump | (alu_out != btb_ctl_i.tgt);
         branch_pc_ex_o  <= alu_out;
-        rf_we_ex_o      <= btb_ctl_i.jump & (alu_out == btb_ctl_i.tgt);
-        alu_rst_ex_o    <= cur_pc_d2_i + 4;
+        //* link is written here even on mispredict, nxt_pc covers c.jalr;
+        rf_we_ex_o      <= 1'b1;
+        alu_rst_ex_o    <= nxt_pc;
       end
       else begin
         alu_rst_ex_o    <= alu_out;
@@ -154,35 +221,73 @@ module N2_exec (
   end
 
   `ifdef ENABLE_BP
-    wire  [15:0]  w_temp_tgt = cur_pc_d2_i + decoded_imm;
+    wire  [31:0]  w_temp_tgt = cur_pc_d2_i + decoded_imm;
+    //* x1/x5 is link register;
+    wire          rd_is_link  = (rf_dst_idu_i == 5'd1) | (rf_dst_idu_i == 5'd5);
+    wire          rs1_is_link = (uop_ctl_i.decoded_rs1 == 5'd1) | (uop_ctl_i.decoded_rs1 == 5'd5);
+    //* btb entry is indexed by the last halfword of instr;
+    wire  [31:0]  w_end_pc    = uop_ctl_i.is_rvc? cur_pc_d2_i: (cur_pc_d2_i + 32'd2);
     always_ff@(posedge clk or negedge resetn) begin
       btb_upd_v_o                     <= 1'b0;
-      btb_upd_info_o.is_jarl          <= 0;
+      btb_upd_info_o.is_ret           <= 0;
+      btb_upd_info_o.is_br            <= 0;
+      btb_upd_info_o.is_call          <= 0;
+      btb_upd_info_o.hit_mbtb         <= btb_ctl_i.hit_mbtb;
+      btb_upd_info_o.way_mbtb         <= btb_ctl_i.way_mbtb;
+      //* checkpoint of ras, used when is_branch_ex_o;
+      ras_fix_o.ras_ptr               <= btb_ctl_i.ras_ptr;
+      ras_fix_o.ras_top               <= btb_ctl_i.ras_top;
+      ras_fix_o.lp_cnt                <= btb_ctl_i.lp_cnt;
+      ras_fix_o.ret_pc                <= nxt_pc;
+      ras_fix_o.push                  <= instr_jalr & rd_is_link;
+      ras_fix_o.pop                   <= instr_jalr & rs1_is_link & 
+                                          (~rd_is_link | (rf_dst_idu_i != uop_ctl_i.decoded_rs1));
+      `ifdef ENABLE_BHT
+        bht_upd_v_o                   <= 1'b0;
+        bht_upd_o.inc_bht             <= alu_out_0;
+        bht_upd_o.bht_idx             <= btb_ctl_i.bht_idx;
+        bht_upd_o.ghr_shift           <= btb_ctl_i.br_hit & (w_end_pc[1] == btb_ctl_i.br_half);
+      `endif
       if(!resetn) begin
         btb_upd_v_o     <= '0;
+        `ifdef ENABLE_BHT
+          bht_upd_v_o   <= '0;
+        `endif
       end
       else if(to_ex_v_i) begin
         if (is_beq_bne_blt_bge_bltu_bgeu) begin
+          `ifdef ENABLE_BHT
+            //* train bht with each conditional branch;
+            bht_upd_v_o               <= 1'b1;
+          `endif
+          btb_upd_info_o.is_br        <= 1;
           //* jump;
           if(alu_out_0) begin
             btb_upd_v_o               <= ~btb_ctl_i.jump | (w_temp_tgt != btb_ctl_i.tgt);
             btb_upd_info_o.valid      <= 1;
-            btb_upd_info_o.pc         <= btb_ctl_i.pc;
+            btb_upd_info_o.pc         <= w_end_pc;
             btb_upd_info_o.tgt        <= w_temp_tgt;
           end
-          //* donot jump
+          //* donot jump, keep btb entry if direction is given by bht;
           else begin
+          `ifdef ENABLE_BHT
+            btb_upd_v_o               <= 1'b0;
+          `else
             btb_upd_v_o               <= btb_ctl_i.jump;
-            btb_upd_info_o.pc         <= btb_ctl_i.pc;
+          `endif
+            btb_upd_info_o.pc         <= w_end_pc;
             btb_upd_info_o.valid      <= 0;
             btb_upd_info_o.tgt        <= 0;
           end
         end
         else if(instr_jalr) begin
           btb_upd_v_o                 <= ~btb_ctl_i.jump | (alu_out != btb_ctl_i.tgt);
-          btb_upd_info_o.is_jarl      <= 1;
+          //* pop then push if both are link (rd != rs1), the same as ras_fix;
+          btb_upd_info_o.is_ret       <= rs1_is_link & 
+                                          (~rd_is_link | (rf_dst_idu_i != uop_ctl_i.decoded_rs1));
+          btb_upd_info_o.is_call      <= rd_is_link;
           btb_upd_info_o.valid        <= 1;
-          btb_upd_info_o.pc           <= btb_ctl_i.pc;
+          btb_upd_info_o.pc           <= w_end_pc;
           btb_upd_info_o.tgt          <= alu_out;
         end 
       end
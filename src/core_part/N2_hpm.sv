@@ -0,0 +1,68 @@
+/*************************************************************/
+//  Module name: N2_hpm
+//  Authority @ lijunnan (lijunnan@nudt.edu.cn)
+//  Last edited time: 2024/07/06
+//  Function outline: hardware performance counters (Zihpm)
+//  Note:
+//    1) mhpmcounter3~(3+HPM_NUM-1) count the event selected by
+//      mhpmevent3~, event id is HPM_EVT_xxx in NanoCore_pkg;
+//    2) csr is read/written by instr0 at d1, write has priority
+//      over counting in the same clk;
+//    3) hpmcounter3~ (0xC03~) is the read-only shadow of mhpmcounter3~;
+/*************************************************************/
+import NanoCore_pkg::*;
+
+module N2_hpm #(
+  parameter HPM_NUM = 4
+) (
+  input clk, resetn,
+
+  input   wire  [hpm_evt_num-1:0] hpm_evt_i,  //* bit i is event i, bit 0 is unused
+  input   wire          csr_we_i,
+  input   wire  [11:0]  csr_addr_i,
+  input   wire  [31:0]  csr_wdata_i,
+  output  logic [31:0]  csr_rdata_o,
+  output  wire  [HPM_NUM-1:0][63:0] hpm_cnt_o
+);
+
+  reg   [HPM_NUM-1:0][63:0] hpm_cnt;
+  reg   [HPM_NUM-1:0][4:0]  hpm_evt;
+  assign hpm_cnt_o = hpm_cnt;
+  //* event id out of range counts nothing;
+  wire  [31:0]  evt       = 32'(hpm_evt_i) & ~32'b1;
+
+  //* csr[11:5]: 0x19 is mhpmevent, 0x58/0x60 is counter (low), 0x5c/0x64 is counter (high);
+  wire  [4:0]   csr_idx   = csr_addr_i[4:0] - 5'd3;
+  wire          csr_evt   = (csr_addr_i[11:5] == 7'h19);
+  wire          csr_high  = csr_addr_i[7];
+  wire          csr_ro    = csr_addr_i[11:10] == 2'b11;
+  always_comb begin
+    csr_rdata_o           = '0;
+    for(integer i=0; i<HPM_NUM; i=i+1)
+      if(i == csr_idx)
+        csr_rdata_o       = csr_evt?  {27'b0, hpm_evt[i]}:
+                            csr_high? hpm_cnt[i][63:32]: hpm_cnt[i][31:0];
+  end
+
+  always_ff @(posedge clk or negedge resetn) begin
+    if(!resetn) begin
+      hpm_cnt             <= '0;
+      hpm_evt             <= '0;
+    end
+    else begin
+      for(integer i=0; i<HPM_NUM; i=i+1) begin
+        if(evt[hpm_evt[i]])
+          hpm_cnt[i]      <= hpm_cnt[i] + 64'd1;
+        if(csr_we_i & ~csr_ro & (i == csr_idx)) begin
+          if(csr_evt)
+            hpm_evt[i]    <= csr_wdata_i[4:0];
+          else if(csr_high)
+            hpm_cnt[i][63:32] <= csr_wdata_i;
+          else
+            hpm_cnt[i][31:0]  <= csr_wdata_i;
+        end
+      end
+    end
+  end
+
+endmodule
@@ -32,6 +32,8 @@ module N2_idu #(
   input   wire          is_branch_ex_i,
   output  reg           is_branch_d2_o,
   output  reg   [31:0]  branch_pc_d2_o,
+  output  wire          redirect_d1_o,  //* direct jump missed in btb
+  output  wire  [31:0]  branch_pc_d1_o,
   
   input   wire  [ 2:0]  iq_prefetch_ptr,
   output  wire  [ 2:0]  iq_rd_ptr_o,
@@ -56,7 +58,7 @@ module N2_idu #(
   input   wire  [ 4:0]  irq_offset_i,
   output  wire  [31:0]  pc_m0_d1_o,
   output  wire  [31:0]  pc_m1_d1_o,
-  output  wire  [31:0]  pc_d2_o,
+  output  wire  [31:0]  link_pc_d2_o,
   output  wire  [31:0]  pc_2ex_d2_o,
   output  reg   [31:0]  pc_m0_d2_o,
   output  reg   [31:0]  pc_m1_d2_o,
@@ -92,6 +94,8 @@ module N2_idu #(
   input   wire          lsu_finish_i,
   input   wire          mu_finish_i,
   input   wire          lsu_stall_idu_i,
+  input   wire          ld_late_i,
+  input   wire  [regindex_bits-1:0] ld_late_dst_i,
 
 `ifdef ENABLE_BP
   input   wire          btb_ctl_m0_v_i,
@@ -101,21 +105,75 @@ module N2_idu #(
   output  btb_ctl_t     btb_ctl_d2_o,
   output  wire          btb_upd_v_d1_o,
   output  btb_t         btb_upd_d1_o,
+  output  ras_fix_t     ras_fix_d1_o,   //* used with redirect_d1_o
+  output  ras_fix_t     ras_fix_d2_o,   //* used with is_branch_d2_o
+  `ifdef ENABLE_HWLOOP
+  output  reg           lp_upd_v_d2_o,  //* used with is_branch_d2_o
+  output  lp_upd_t      lp_upd_d2_o,
+  output  wire          lp_en_o,        //* loop back is off in irq handler
+  `endif
 `endif
   input   wire  [31:0]  alu_rst_ex0_i,
   input   wire  [31:0]  alu_rst_ex1_i,
   input   wire  [31:0]  alu_rst_lsu_i,
 
+`ifdef ENABLE_HPM
+  input   wire          icache_miss_i,
+  input   wire          dcache_miss_i,
+  input   wire          mu_busy_i,
+  output  wire  [`HPM_NUM-1:0][63:0] hpm_cnt_o,
+`endif
+`ifdef ENABLE_IRQ_SHADOW
+  output  wire          rf_bank_o,      //* 1: shadow bank (irq handler)
+`endif
   output  wire  [63:0]  count_instr_o,
   output  wire  [63:0]  count_cycle_o
 );
   `ifdef ENABLE_BP
     btb_ctl_t           btb_ctl_m0_d1, btb_ctl_m1_d1;
     btb_ctl_t           btb_ctl_m0_d2, btb_ctl_m1_d2;
+  `ifdef ENABLE_HWLOOP
+    //* lp.starti/endi/count/counti/setup/setupi (funct3 is 0~5):
+    //*   1) start/end = pc + (uimmL<<1), end is the addr following the last instr;
+    //*   2) setup/setupi: start = pc + 4, end = pc + (uimmL<<1) / (uimmS<<1);
+    //*   3) count = rs1 (count/setup) or uimmL (counti/setupi);
+    wire  [ 2:0]        lp_op     = uop_ctl_m0_d1_o.hwlp_op;
+    wire  [11:0]        lp_uimm_l = uop_ctl_m0_d1_o.decoded_imm[11:0];
+    wire  [ 4:0]        lp_uimm_s = uop_ctl_m0_d1_o.decoded_imm[16:12];
+  `endif
     always_ff @(posedge clk) begin
       btb_ctl_m0_d2     <= btb_ctl_m0_d1;
       btb_ctl_m1_d2     <= btb_ctl_m1_d1;
+      //* irq from d1, or retirq (recover checkpoint only);
+      ras_fix_d2_o      <= ras_fix_d1_o;
+      if(uop_ctl_m0_v_d1_o & uop_ctl_m0_d1_o.instr_retirq) begin
+        ras_fix_d2_o.push     <= 1'b0;
+        ras_fix_d2_o.pop      <= 1'b0;
+        ras_fix_d2_o.ras_ptr  <= btb_ctl_m0_d1.ras_ptr;
+        ras_fix_d2_o.ras_top  <= btb_ctl_m0_d1.ras_top;
+        ras_fix_d2_o.lp_cnt   <= btb_ctl_m0_d1.lp_cnt;
+      end
+      else if(uop_ctl_m1_v_d1_o & uop_ctl_m1_d1_o.instr_retirq) begin
+        ras_fix_d2_o.push     <= 1'b0;
+        ras_fix_d2_o.pop      <= 1'b0;
+        ras_fix_d2_o.ras_ptr  <= btb_ctl_m1_d1.ras_ptr;
+        ras_fix_d2_o.ras_top  <= btb_ctl_m1_d1.ras_top;
+        ras_fix_d2_o.lp_cnt   <= btb_ctl_m1_d1.lp_cnt;
+      end
+    `ifdef ENABLE_HWLOOP
+      //* lp.* (instr0 only), new count is given with the checkpoint;
+      else if(uop_ctl_m0_v_d1_o & uop_ctl_m0_d1_o.is_hwlp & ~is_branch_ex_i) begin
+        ras_fix_d2_o.push     <= 1'b0;
+        ras_fix_d2_o.pop      <= 1'b0;
+        ras_fix_d2_o.ras_ptr  <= btb_ctl_m0_d1.ras_ptr;
+        ras_fix_d2_o.ras_top  <= btb_ctl_m0_d1.ras_top;
+        ras_fix_d2_o.lp_cnt   <= btb_ctl_m0_d1.lp_cnt;
+        if(lp_op[1] | lp_op[2])
+          ras_fix_d2_o.lp_cnt[uop_ctl_m0_d1_o.hwlp_level] <= lp_op[0]? 32'(lp_uimm_l): cpuregs_rs1_m0;
+      end
+    `endif
     end
+
   `endif
 
   reg   [31:0]  alu_op1_m0_d2, alu_op2_m0_d2,
@@ -216,10 +274,13 @@ end
 
   wire is_jal_m0_d1 = uop_ctl_m0_d1_o.instr_jal;
   wire is_jal_m1_d1 = uop_ctl_m1_d1_o.instr_jal;
-  assign pc_d2_o    = uop_ctl_m0_d2_o.instr_jal? pc_m0_d2_o: pc_m1_d2_o;
+  //* link of the jal redirected at d1, i.e., pc+2 for c.jal;
+  assign link_pc_d2_o = uop_ctl_m0_d2_o.instr_jal? (pc_m0_d2_o + (uop_ctl_m0_d2_o.is_rvc? 32'd2: 32'd4)):
+                                                   (pc_m1_d2_o + (uop_ctl_m1_d2_o.is_rvc? 32'd2: 32'd4));
   reg to_ex0_v, to_ex1_v, to_ld_v, to_st_v, to_mu_v;
   //* cancel current inst while meeting flush;
   wire flush = is_branch_d2_o | is_branch_ex_i;
+  logic [31:0]  hpm_rdata;
   assign to_ex0_v_o= ~is_branch_ex_i & to_ex0_v;
   assign to_ex1_v_o= ~is_branch_ex_i & to_ex1_v;
   assign to_ld_v_o = ~is_branch_ex_i & to_ld_v;
@@ -234,9 +295,32 @@ end
   reg           irq_processing, irq_processing_delay1;
   wire          irq_processing_d1;
   wire  [31:0]  irq_retPC;
+`ifdef ENABLE_IRQ_SHADOW
+  //* switched 1 clk after irq is taken (at d1) or retirq (at d1), rf writes are
+  //*   drained before (see stall_scb_m0), and recovered with irq_processing;
+  assign rf_bank_o = irq_processing;
+`endif
+`ifdef ENABLE_HWLOOP
+  assign lp_en_o   = ~irq_processing;
+`endif
   wire  [ 1:0]  is_branch_d1_o;
-  wire  [31:0]  branch_pc_d1_o;
   wire  [regindex_bits-1:0] rf_dst_d1;
+`ifdef ENABLE_HWLOOP
+  //* start/end are sent to ifu with the flush, and count with ras_fix_d2_o;
+  always_ff @(posedge clk) begin
+    //* lp.* at d1 may be on the wrong path of an older branch in exec;
+    lp_upd_v_d2_o         <= uop_ctl_m0_v_d1_o & ~is_branch_d2_o & ~is_branch_d1_o[0] & 
+                              ~is_branch_ex_i & uop_ctl_m0_d1_o.is_hwlp;
+    lp_upd_d2_o.level     <= uop_ctl_m0_d1_o.hwlp_level;
+    lp_upd_d2_o.set_start <= (lp_op == 3'b000) | lp_op[2];
+    lp_upd_d2_o.set_end   <= (lp_op == 3'b001) | lp_op[2];
+    lp_upd_d2_o.start     <= lp_op[2]? (pc_m0_d1_o + 32'd4): (pc_m0_d1_o + {lp_uimm_l, 1'b0});
+    lp_upd_d2_o.last      <= (lp_op == 3'b101)? (pc_m0_d1_o + {lp_uimm_s, 1'b0} - 32'd2):
+                              (pc_m0_d1_o + {lp_uimm_l, 1'b0} - 32'd2);
+    if(!resetn)
+      lp_upd_v_d2_o       <= 1'b0;
+  end
+`endif
   always_ff @(posedge clk or negedge resetn) begin
     //* d1 to d2
     irq_ack_d2          <= irq_ack_d1;
@@ -244,7 +328,8 @@ end
     pc_m1_d2_o          <= pc_m1_d1_o;
     uop_ctl_m0_d2_o     <= uop_ctl_m0_d1_o;
     uop_ctl_m1_d2_o     <= uop_ctl_m1_d1_o;
-    uop_ctl_m0_d2_o.waddr <= uop_ctl_m0_d1_o.decoded_imm + cpuregs_rs1_m0;
+    uop_ctl_m0_d2_o.waddr <= uop_ctl_m0_d1_o.decoded_imm + cpuregs_rs1_m0 + 
+                              (uop_ctl_m0_d1_o.is_ld_idx? cpuregs_rs2_m0: 32'b0);
     uop_ctl_m1_d2_o.waddr <= uop_ctl_m1_d1_o.decoded_imm + cpuregs_rs1_m1;
     is_branch_d2_o      <= (|is_branch_d1_o) & ~flush;
     branch_pc_d2_o      <= branch_pc_d1_o;
@@ -291,7 +376,7 @@ end
         end
         uop_ctl_m0_d1_o.instr_jal: begin
           rf_we_d2_o        <= 1;
-          alu_rst_d2_o      <= pc_m0_d1_o + 4;
+          alu_rst_d2_o      <= pc_m0_d1_o + (uop_ctl_m0_d1_o.is_rvc? 32'd2: 32'd4);
         end
         uop_ctl_m0_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh,
         uop_ctl_m1_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh: begin
@@ -320,14 +405,26 @@ end
           `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m0_d1_o.decoded_rs1, cpuregs_rs1_m0);)
           irq_mask_o        <= cpuregs_rs1_m0;
         end
+        uop_ctl_m0_d1_o.is_hwlp: begin
+          //* refetch the following instr with new hwloop regs;
+          is_branch_d2_o    <= ~is_branch_ex_i;
+          branch_pc_d2_o    <= is_branch_ex_i? branch_pc_d1_o: (pc_m0_d1_o + 32'd4);
+        end
+        uop_ctl_m0_d1_o.is_csr_hpm: begin
+          rf_we_d2_o        <= 'b1;
+          alu_rst_d2_o      <= hpm_rdata;
+        end
         uop_ctl_m0_d1_o.is_lb_lh_lw_lbu_lhu && !uop_ctl_m0_d1_o.instr_trap: begin
           `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m0_d1_o.decoded_rs1, cpuregs_rs1_m0);)
           alu_op1_m0_d2     <= cpuregs_rs1_m0;
+          alu_op2_m0_d2     <= cpuregs_rs2_m0;  //* wdata of sc/amo
         end
-        uop_ctl_m0_d1_o.is_jalr_addi_slti_sltiu_xori_ori_andi, uop_ctl_m0_d1_o.is_slli_srli_srai: begin
+        uop_ctl_m0_d1_o.is_jalr_addi_slti_sltiu_xori_ori_andi, uop_ctl_m0_d1_o.is_slli_srli_srai,
+        uop_ctl_m0_d1_o.is_zb_imm: begin
           `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m0_d1_o.decoded_rs1, cpuregs_rs1_m0);)
           alu_op1_m0_d2     <= cpuregs_rs1_m0;
-          alu_op2_m0_d2     <= uop_ctl_m0_d1_o.is_slli_srli_srai? uop_ctl_m0_d1_o.decoded_rs2 : uop_ctl_m0_d1_o.decoded_imm;
+          alu_op2_m0_d2     <= (uop_ctl_m0_d1_o.is_slli_srli_srai | uop_ctl_m0_d1_o.is_zb_imm)? 
+                                uop_ctl_m0_d1_o.decoded_rs2 : uop_ctl_m0_d1_o.decoded_imm;
         end
         default: begin
           `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m0_d1_o.decoded_rs1, cpuregs_rs1_m0);)
@@ -345,7 +442,7 @@ end
           end
           uop_ctl_m1_d1_o.instr_jal: begin
             rf_we_d2_o        <= 1;
-            alu_rst_d2_o      <= pc_m1_d1_o + 4;
+            alu_rst_d2_o      <= pc_m1_d1_o + (uop_ctl_m1_d1_o.is_rvc? 32'd2: 32'd4);
             rf_dst_d2_o       <= uop_ctl_m1_d1_o.decoded_rd;
           end
           uop_ctl_m1_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh: begin
@@ -379,11 +476,14 @@ end
           uop_ctl_m1_d1_o.is_lb_lh_lw_lbu_lhu && !uop_ctl_m1_d1_o.instr_trap: begin
             `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m1_d1_o.decoded_rs1, cpuregs_rs1_m1);)
             alu_op1_m1_d2     <= cpuregs_rs1_m1;
+            alu_op2_m1_d2     <= cpuregs_rs2_m1;  //* wdata of sc/amo
           end
-          uop_ctl_m1_d1_o.is_jalr_addi_slti_sltiu_xori_ori_andi, uop_ctl_m1_d1_o.is_slli_srli_srai: begin
+          uop_ctl_m1_d1_o.is_jalr_addi_slti_sltiu_xori_ori_andi, uop_ctl_m1_d1_o.is_slli_srli_srai,
+          uop_ctl_m1_d1_o.is_zb_imm: begin
             `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m1_d1_o.decoded_rs1, cpuregs_rs1_m1);)
             alu_op1_m1_d2     <= cpuregs_rs1_m1;
-            alu_op2_m1_d2     <= uop_ctl_m1_d1_o.is_slli_srli_srai? uop_ctl_m1_d1_o.decoded_rs2 : uop_ctl_m1_d1_o.decoded_imm;
+            alu_op2_m1_d2     <= (uop_ctl_m1_d1_o.is_slli_srli_srai | uop_ctl_m1_d1_o.is_zb_imm)? 
+                                  uop_ctl_m1_d1_o.decoded_rs2 : uop_ctl_m1_d1_o.decoded_imm;
           end
           default: begin
             `debug($display("LD_RS1: %2d 0x%08x", uop_ctl_m1_d1_o.decoded_rs1, cpuregs_rs1_m1);)
@@ -403,6 +503,8 @@ end
           uop_ctl_m0_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh,
           uop_ctl_m0_d1_o.instr_retirq,
           uop_ctl_m0_d1_o.instr_maskirq,
+          uop_ctl_m0_d1_o.is_csr_hpm,
+          uop_ctl_m0_d1_o.is_hwlp,
           uop_ctl_m0_d1_o.instr_jal: begin
           end
           uop_ctl_m0_d1_o.is_lb_lh_lw_lbu_lhu && !uop_ctl_m0_d1_o.instr_trap: to_ld_v <= 1'b1;
@@ -449,15 +551,35 @@ end
   wire                      rf_we_ex1_ns  = to_ex1_v_o & ~uop_ctl_m1_d2_o.is_beq_bne_blt_bge_bltu_bgeu;
   wire  [regindex_bits-1:0] rf_dst_ex1_ns = uop_ctl_m1_d2_o.decoded_rd;
 
-  uop_ctl_t     uop_ctl_m0_ifu, uop_ctl_m1_ifu;
+`ifndef ENABLE_RVC
+  //* pre-decode before iq, (with ENABLE_RVC, it is done at iq read after realign);
+  uop_ctl_t     uop_ctl_m0_ifu, uop_ctl_m1_ifu, uop_pre_m0_ifu, uop_pre_m1_ifu,
+                uop_ext_m0_ifu, uop_ext_m1_ifu;
   N2_idu_predecode N2_idu_predecode_i0(
     .instr_rdata_i    (instr_rdata_i[31:0]  ),
-    .uop_ctl          (uop_ctl_m0_ifu       )
+    .uop_ctl          (uop_pre_m0_ifu       )
   );
   N2_idu_predecode N2_idu_predecode_i1(
     .instr_rdata_i    (instr_rdata_i[63:32] ),
-    .uop_ctl          (uop_ctl_m1_ifu       )
+    .uop_ctl          (uop_pre_m1_ifu       )
   );
+  N2_idu_decode_ext N2_idu_decode_ext_i0(
+    .instr_rdata_i    (instr_rdata_i[31:0]  ),
+    .uop_ctl_i        (uop_pre_m0_ifu       ),
+    .uop_ctl_o        (uop_ext_m0_ifu       )
+  );
+  N2_idu_decode_ext N2_idu_decode_ext_i1(
+    .instr_rdata_i    (instr_rdata_i[63:32] ),
+    .uop_ctl_i        (uop_pre_m1_ifu       ),
+    .uop_ctl_o        (uop_ext_m1_ifu       )
+  );
+  always_comb begin
+    uop_ctl_m0_ifu        = uop_ext_m0_ifu;
+    uop_ctl_m0_ifu.is_rvc = 1'b0;
+    uop_ctl_m1_ifu        = uop_ext_m1_ifu;
+    uop_ctl_m1_ifu.is_rvc = 1'b0;
+  end
+`endif
 
   N2_idu_decode #(
     .PROGADDR_RESET   (PROGADDR_RESET   ),
@@ -468,8 +590,12 @@ end
     .iq_prefetch_ptr  (iq_prefetch_ptr  ),
     .iq_rd_ptr_o      (iq_rd_ptr_o      ),
     .uop_ctl_v_ifu_i  (instr_ready_i    ),
+  `ifdef ENABLE_RVC
+    .instr_rdata_ifu_i(instr_rdata_i    ),
+  `else
     .uop_ctl_m0_ifu_i (uop_ctl_m0_ifu   ),
     .uop_ctl_m1_ifu_i (uop_ctl_m1_ifu   ),
+  `endif
     .uop_ctl_m0_v_d1_o(uop_ctl_m0_v_d1_o),
     .uop_ctl_m0_d1_o  (uop_ctl_m0_d1_o  ),
     .uop_ctl_m1_v_d1_o(uop_ctl_m1_v_d1_o),
@@ -483,6 +609,7 @@ end
     .is_branch_ex_i   (is_branch_ex_i   ),
 
     .is_branch_d1_o   (is_branch_d1_o   ),
+    .redirect_d1_o    (redirect_d1_o    ),
     .rf_dst_d1_o      (rf_dst_d1        ),
     .branch_pc_d1_o   (branch_pc_d1_o   ),
     .irq_processing_i (irq_processing   ),
@@ -511,6 +638,8 @@ end
     .lsu_finish_i     (lsu_finish_i     ),
     .mu_finish_i      (mu_finish_i      ),
     .lsu_stall_idu_i  (lsu_stall_idu_i  ),
+    .ld_late_i        (ld_late_i        ),
+    .ld_late_dst_i    (ld_late_dst_i    ),
 
   `ifdef ENABLE_BP
     .btb_ctl_m0_v_i   (btb_ctl_m0_v_i   ),
@@ -521,12 +650,51 @@ end
     .btb_ctl_m1_d1_o  (btb_ctl_m1_d1    ),
     .btb_upd_v_d1_o   (btb_upd_v_d1_o   ),
     .btb_upd_d1_o     (btb_upd_d1_o     ),
+    .ras_fix_d1_o     (ras_fix_d1_o     ),
   `endif
 
     .count_cycle      (count_cycle_o    ),
     .count_instr      (count_instr_o    )
   );
 
+  //* hpm csr is accessed by instr0 at d1, rd is written with the old value;
+`ifdef ENABLE_HPM
+  wire  [hpm_evt_num-1:0] hpm_evt;
+  wire          hpm_we    = uop_ctl_m0_v_d1_o & ~is_branch_d2_o & ~is_branch_d1_o[0] &
+                            ~is_branch_ex_i & uop_ctl_m0_d1_o.is_csr_hpm &
+                            (uop_ctl_m0_d1_o.instr_csrrw | (uop_ctl_m0_d1_o.decoded_rs1 != 0));
+  wire  [31:0]  hpm_wdata = uop_ctl_m0_d1_o.instr_csrrw?  cpuregs_rs1_m0:
+                            uop_ctl_m0_d1_o.instr_csrrs?  (hpm_rdata | cpuregs_rs1_m0):
+                                                          (hpm_rdata & ~cpuregs_rs1_m0);
+  assign hpm_evt[0]                 = 1'b0;
+  assign hpm_evt[HPM_EVT_BR_MISS]   = is_branch_ex_i;
+  assign hpm_evt[HPM_EVT_JAL_MISS]  = redirect_d1_o;
+  assign hpm_evt[HPM_EVT_IC_MISS]   = icache_miss_i;
+  assign hpm_evt[HPM_EVT_DC_MISS]   = dcache_miss_i;
+  assign hpm_evt[HPM_EVT_LSQ_FULL]  = lsu_stall_idu_i;
+  assign hpm_evt[HPM_EVT_MU_BUSY]   = mu_busy_i;
+  assign hpm_evt[HPM_EVT_ISSUE0]    = ~uop_ctl_m0_v_d1_o;
+  assign hpm_evt[HPM_EVT_ISSUE1]    = uop_ctl_m0_v_d1_o & ~uop_ctl_m1_v_d1_o;
+  assign hpm_evt[HPM_EVT_ISSUE2]    = uop_ctl_m0_v_d1_o & uop_ctl_m1_v_d1_o;
+  assign hpm_evt[HPM_EVT_IRQ]       = irq_ack_o;
+  assign hpm_evt[HPM_EVT_IRQ_CLK]   = irq_processing;
+
+  N2_hpm #(
+    .HPM_NUM          (`HPM_NUM         )
+  ) N2_hpm (
+    .clk              (clk              ),
+    .resetn           (resetn           ),
+    .hpm_evt_i        (hpm_evt          ),
+    .csr_we_i         (hpm_we           ),
+    .csr_addr_i       (uop_ctl_m0_d1_o.decoded_imm[11:0]),
+    .csr_wdata_i      (hpm_wdata        ),
+    .csr_rdata_o      (hpm_rdata        ),
+    .hpm_cnt_o        (hpm_cnt_o        )
+  );
+`else
+  assign hpm_rdata    = '0;
+`endif
+
   assign uid_2ex0_d2_o  = uid_d2_o;
   assign uid_2ex1_d2_o  = uid_d2_o + uid_we_d2_o[0]|uid_ready_we_d2_o[0];
   assign uid_2mu_d2_o   = mu_sel? (uid_d2_o + uid_we_d2_o[0]|uid_ready_we_d2_o[0]) : uid_d2_o;
@@ -549,7 +717,9 @@ end
                                 uop_ctl_m0_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh |
                                 uop_ctl_m1_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh |
                                 uop_ctl_m0_d1_o.instr_retirq |
-                                uop_ctl_m0_d1_o.instr_maskirq);
+                                uop_ctl_m0_d1_o.instr_maskirq |
+                                uop_ctl_m0_d1_o.is_csr_hpm |
+                                uop_ctl_m0_d1_o.is_hwlp);
       uid_ready_we_d2[1]  <= uop_ctl_m1_v_d1_o & ~is_branch_d2_o &
                                 uop_ctl_m1_d1_o.instr_jal | 
                                 uop_ctl_m1_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh |
@@ -564,7 +734,9 @@ end
           end
           uop_ctl_m0_d1_o.is_rdcycle_rdcycleh_rdinstr_rdinstrh,
           uop_ctl_m0_d1_o.instr_retirq,
-          uop_ctl_m0_d1_o.instr_maskirq: begin
+          uop_ctl_m0_d1_o.instr_maskirq,
+          uop_ctl_m0_d1_o.is_csr_hpm,
+          uop_ctl_m0_d1_o.is_hwlp: begin
           end
           default: uid_we_d2[0]  <= ~uop_ctl_m0_d1_o.is_sb_sh_sw & ~uop_ctl_m0_d1_o.is_beq_bne_blt_bge_bltu_bgeu &
                                     |uop_ctl_m0_d1_o.decoded_rd;
@@ -16,8 +16,12 @@ module N2_idu_decode #(
   input   wire  [2:0]   iq_prefetch_ptr,
   output  wire  [2:0]   iq_rd_ptr_o,
   input   wire  [1:0]   uop_ctl_v_ifu_i,
+`ifdef ENABLE_RVC
+  input   wire  [63:0]  instr_rdata_ifu_i,  //* raw instr, realigned & pre-decoded in d0
+`else
   input   uop_ctl_t     uop_ctl_m0_ifu_i,
   input   uop_ctl_t     uop_ctl_m1_ifu_i,
+`endif
   output  wire          uop_ctl_m0_v_d1_o,
   output  uop_ctl_t     uop_ctl_m0_d1_o,
   output  wire          uop_ctl_m1_v_d1_o,
@@ -31,7 +35,8 @@ module N2_idu_decode #(
   input   wire          flush_i,
   input   wire          is_branch_d2_i,
   input   wire          is_branch_ex_i,
-  output  reg   [1:0]   is_branch_d1_o,           
+  output  reg   [1:0]   is_branch_d1_o,           //* irq, redirected at d2
+  output  wire          redirect_d1_o,            //* direct jump, redirected at d1
   output  reg   [regindex_bits-1:0] rf_dst_d1_o,  //* only for instr0 (irq)
   output  reg   [31:0]  branch_pc_d1_o,           //* merged (instr0/1)
   input   wire          irq_processing_i,
@@ -56,6 +61,8 @@ module N2_idu_decode #(
   input   wire          lsu_finish_i,
   input   wire          mu_finish_i,
   input   wire          lsu_stall_idu_i,
+  input   wire          ld_late_i,
+  input   wire  [regindex_bits-1:0] ld_late_dst_i,
 
 `ifdef ENABLE_BP
   input   wire          btb_ctl_m0_v_i,
@@ -66,6 +73,7 @@ module N2_idu_decode #(
   output  btb_ctl_t     btb_ctl_m1_d1_o,
   output  reg           btb_upd_v_d1_o,
   output  btb_t         btb_upd_d1_o,
+  output  ras_fix_t     ras_fix_d1_o,   //* used with is_branch_d1_o/redirect_d1_o
 `endif
 
   output  reg   [63:0]  count_cycle,
@@ -76,16 +84,56 @@ module N2_idu_decode #(
                 iq_not_empty_m1, iq_bypass_m1;
   reg   [2:0]   iq_wr_ptr, iq_rd_ptr;
   wire  [2:0]   iq_rd_ptr_nxt = iq_rd_ptr + 3'd1;
-  uop_ctl_t     uop_ctl_m0_d0, uop_ctl_m1_d0;
+`ifdef ENABLE_RVC
+  //* iq_rd_half: next instr starts at the upper halfword of iq_rd_ptr;
+  //* rvc_p1/p2: halfword position in read window after instr0/1;
+  reg           iq_rd_half;
+  logic         rvc_v_m0, rvc_v_m1;
+  logic [2:0]   rvc_p1, rvc_p2;
+`endif
+  //* uop_raw: read from iq, uop_ctl: after fusion;
+  uop_ctl_t     uop_raw_m0_d0, uop_raw_m1_d0, uop_ctl_m0_d0, uop_ctl_m1_d0;
   //* allow_instr1: no conflict between instr0 and instr1 
   logic         stall_scb_m0, stall_scb_m1, allow_instr1;
+  //* with shadow rf, irq is taken and retirq is issued (only as instr0) when no
+  //*   rf write is in flight, so that all writes go to the bank of their instr;
+`ifdef ENABLE_IRQ_SHADOW
+  logic         scb_idle;
+  wire          retirq_m1 = uop_ctl_m1_d0.instr_retirq;
+`else
+  wire          scb_idle  = 1'b1;
+  wire          retirq_m1 = 1'b0;
+`endif
   reg           uop_ctl_m0_v_d1, uop_ctl_m1_v_d1;
   assign        uop_ctl_m0_v_d1_o = uop_ctl_m0_v_d1 & ~flush_i;
   assign        uop_ctl_m1_v_d1_o = uop_ctl_m1_v_d1 & ~flush_i;
   btb_ctl_t btb_ctl_m0_d0, btb_ctl_m1_d0;
+  //* jal with x1/x5 as rd is call;
+  wire      rd_is_link_m0 = (uop_ctl_m0_d0.decoded_rd == 5'd1) | (uop_ctl_m0_d0.decoded_rd == 5'd5);
+  wire      rd_is_link_m1 = (uop_ctl_m1_d0.decoded_rd == 5'd1) | (uop_ctl_m1_d0.decoded_rd == 5'd5);
+  //* pc of the last halfword, used by btb & ras (ret_pc = end_pc + 2);
+  wire [31:0] end_pc_m0 = uop_ctl_m0_d0.is_rvc? btb_ctl_m0_d0.pc: (btb_ctl_m0_d0.pc + 32'd2);
+  wire [31:0] end_pc_m1 = uop_ctl_m1_d0.is_rvc? btb_ctl_m1_d0.pc: (btb_ctl_m1_d0.pc + 32'd2);
+  //* direct jump is resolved at d0: jal, or backward branch missed in btb (static
+  //*   predicted taken, checked by exec as a btb hit); it is redirected at d1 
+  //*   if not predicted by btb, and installed in btb at the same time;
+  wire        br_tkn_m0   = uop_ctl_m0_d0.is_beq_bne_blt_bge_bltu_bgeu & uop_ctl_m0_d0.decoded_imm[31] &
+                            ~btb_ctl_m0_d0.hit & ~btb_ctl_m0_d0.jump;
+  wire        br_tkn_m1   = uop_ctl_m1_d0.is_beq_bne_blt_bge_bltu_bgeu & uop_ctl_m1_d0.decoded_imm[31] &
+                            ~btb_ctl_m1_d0.hit & ~btb_ctl_m1_d0.jump;
+  wire [31:0] dir_tgt_m0  = btb_ctl_m0_d0.pc + (uop_ctl_m0_d0.instr_jal? uop_ctl_m0_d0.decoded_imm_j: 
+                                                                         uop_ctl_m0_d0.decoded_imm);
+  wire [31:0] dir_tgt_m1  = btb_ctl_m1_d0.pc + (uop_ctl_m1_d0.instr_jal? uop_ctl_m1_d0.decoded_imm_j: 
+                                                                         uop_ctl_m1_d0.decoded_imm);
+  wire        dir_miss_m0 = ~btb_ctl_m0_d0.jump | (dir_tgt_m0 != btb_ctl_m0_d0.tgt);
+  wire        dir_miss_m1 = ~btb_ctl_m1_d0.jump | (dir_tgt_m1 != btb_ctl_m1_d0.tgt);
+  //* cancelled by flush from d2/ex (older instr);
+  reg         redirect_d1;
+  assign      redirect_d1_o = redirect_d1 & ~flush_i;
   reg    [1:0][2:0]  alu_op_bypass_m0_2d2, alu_op_bypass_m1_2d2;
   always_ff @(posedge clk) begin
     is_branch_d1_o            <= '0;
+    redirect_d1               <= '0;
     uop_ctl_m0_v_d1           <= '0;
     uop_ctl_m1_v_d1           <= '0;
     uop_ctl_m0_d1_o           <= '0;
@@ -119,28 +167,41 @@ module N2_idu_decode #(
     alu_op_bypass_m0_d2_o[0]  <= uop_ctl_m0_d1_o.is_lui_auipc_jal? '0: alu_op_bypass_m0_2d2[0];
     alu_op_bypass_m0_d2_o[1]  <= uop_ctl_m0_d1_o.is_lui_auipc_jal |
                                   uop_ctl_m0_d1_o.is_jalr_addi_slti_sltiu_xori_ori_andi|
-                                  uop_ctl_m0_d1_o.is_slli_srli_srai? '0: alu_op_bypass_m0_2d2[1];
+                                  uop_ctl_m0_d1_o.is_slli_srli_srai | 
+                                  uop_ctl_m0_d1_o.is_zb_imm? '0: alu_op_bypass_m0_2d2[1];
     alu_op_bypass_m1_d2_o[0]  <= uop_ctl_m1_d1_o.is_lui_auipc_jal? '0: alu_op_bypass_m1_2d2[0];
     alu_op_bypass_m1_d2_o[1]  <= uop_ctl_m1_d1_o.is_lui_auipc_jal |
                                   uop_ctl_m1_d1_o.is_jalr_addi_slti_sltiu_xori_ori_andi|
-                                  uop_ctl_m1_d1_o.is_slli_srli_srai? '0: alu_op_bypass_m1_2d2[1];
+                                  uop_ctl_m1_d1_o.is_slli_srli_srai | 
+                                  uop_ctl_m1_d1_o.is_zb_imm? '0: alu_op_bypass_m1_2d2[1];
     irq_processing_d1_o       <= 1'b0;
-    btb_upd_d1_o.is_jarl      <= 0;
+    btb_upd_d1_o.is_ret       <= 0;
+    btb_upd_d1_o.is_br        <= 0;
+    btb_upd_d1_o.is_call      <= 0;
     if(!resetn) begin
+      redirect_d1             <= 1'b0;
       irq_processing_d1_o     <= 1'b0;
       iq_rd_ptr               <= '0;
+    `ifdef ENABLE_RVC
+      iq_rd_half              <= 1'b0;
+    `endif
       uop_ctl_m0_v_d1         <= '0;
       uop_ctl_m1_v_d1         <= '0;
     end
     else begin
       rf_dst_d1_o             <= uop_ctl_m0_d0.decoded_rd;
       //* decode;
-      if (~stall_scb_m0 && (iq_not_empty_m0 |iq_bypass_m0) && ~flush_i && ~(|is_branch_d1_o)) begin
+      if (~stall_scb_m0 && (iq_not_empty_m0 |iq_bypass_m0) && ~flush_i && ~(|is_branch_d1_o) && 
+          ~redirect_d1) begin
         uop_ctl_m0_v_d1       <= 1'b1;
         uop_ctl_m0_d1_o       <= uop_ctl_m0_d0;
         count_instr[31:0]     <= count_instr[31:0] + 1;
         count_instr[63:32]    <= &count_instr[31:0]? (count_instr[63:32] + 1): count_instr[63:32];
+      `ifdef ENABLE_RVC
+        {iq_rd_ptr,iq_rd_half}<= {iq_rd_ptr + rvc_p1[2:1], rvc_p1[0]};
+      `else
         iq_rd_ptr             <= iq_rd_ptr + 3'd1;
+      `endif
 
         //* TODO!!!
         if(~stall_scb_m1 & (iq_not_empty_m1 | iq_bypass_m1) & allow_instr1) begin
@@ -148,17 +209,29 @@ module N2_idu_decode #(
           uop_ctl_m1_d1_o     <= uop_ctl_m1_d0;
           count_instr[31:0]   <= count_instr + 2;
           count_instr[63:32]  <= &count_instr[31:1]? (count_instr[63:32] + 1): count_instr[63:32];
+        `ifdef ENABLE_RVC
+          {iq_rd_ptr,iq_rd_half}  <= {iq_rd_ptr + rvc_p2[2:1], rvc_p2[0]};
+        `else
           iq_rd_ptr           <= iq_rd_ptr + 3'd2;
-          if (uop_ctl_m1_d0.instr_jal) begin
-            branch_pc_d1_o    <= btb_ctl_m1_d0.pc + uop_ctl_m1_d0.decoded_imm_j;
+        `endif
+          if (uop_ctl_m1_d0.instr_jal | br_tkn_m1) begin
+            branch_pc_d1_o    <= dir_tgt_m1;
             //* update sbp
-            btb_upd_v_d1_o    <= ~btb_ctl_m1_d0.jump | 
-                                ((btb_ctl_m1_d0.pc + uop_ctl_m1_d0.decoded_imm_j)!=btb_ctl_m1_d0.tgt);
+            btb_upd_v_d1_o    <= dir_miss_m1;
             btb_upd_d1_o.valid<= 1;
-            btb_upd_d1_o.pc   <= btb_ctl_m1_d0.pc;
-            btb_upd_d1_o.tgt  <= btb_ctl_m1_d0.pc + uop_ctl_m1_d0.decoded_imm_j;
-            is_branch_d1_o[1] <= ~btb_ctl_m1_d0.jump | 
-                                ((btb_ctl_m1_d0.pc + uop_ctl_m1_d0.decoded_imm_j)!=btb_ctl_m1_d0.tgt);;
+            btb_upd_d1_o.pc   <= end_pc_m1;
+            btb_upd_d1_o.tgt  <= dir_tgt_m1;
+            btb_upd_d1_o.is_br    <= br_tkn_m1;
+            btb_upd_d1_o.is_call  <= uop_ctl_m1_d0.instr_jal & rd_is_link_m1;
+            btb_upd_d1_o.hit_mbtb <= btb_ctl_m1_d0.hit_mbtb;
+            btb_upd_d1_o.way_mbtb <= btb_ctl_m1_d0.way_mbtb;
+            ras_fix_d1_o.push     <= uop_ctl_m1_d0.instr_jal & rd_is_link_m1;
+            ras_fix_d1_o.pop      <= 1'b0;
+            ras_fix_d1_o.ras_ptr  <= btb_ctl_m1_d0.ras_ptr;
+            ras_fix_d1_o.ras_top  <= btb_ctl_m1_d0.ras_top;
+            ras_fix_d1_o.ret_pc   <= end_pc_m1 + 32'd2;
+            ras_fix_d1_o.lp_cnt   <= btb_ctl_m1_d0.lp_cnt;
+            redirect_d1       <= dir_miss_m1;
           end
         end
 
@@ -170,24 +243,42 @@ module N2_idu_decode #(
           irq_processing_d1_o <= 1'b1;
           branch_pc_d1_o      <= PROGADDR_IRQ + (irq_offset_i<<2);
           is_branch_d1_o      <= 2'b1;
+          redirect_d1         <= 1'b0;
+          //* instr0 is replaced by irq;
+          ras_fix_d1_o.push   <= 1'b0;
+          ras_fix_d1_o.pop    <= 1'b0;
+          ras_fix_d1_o.ras_ptr<= btb_ctl_m0_d0.ras_ptr;
+          ras_fix_d1_o.ras_top<= btb_ctl_m0_d0.ras_top;
+          ras_fix_d1_o.lp_cnt <= btb_ctl_m0_d0.lp_cnt;
           rf_dst_d1_o         <= '0;
         end
-        else if (uop_ctl_m0_d0.instr_jal) begin
-          branch_pc_d1_o      <= btb_ctl_m0_d0.pc + uop_ctl_m0_d0.decoded_imm_j;
+        else if (uop_ctl_m0_d0.instr_jal | br_tkn_m0) begin
+          branch_pc_d1_o      <= dir_tgt_m0;
           //* update sbp
-          btb_upd_v_d1_o      <= ~btb_ctl_m0_d0.jump| 
-                                ((btb_ctl_m0_d0.pc + uop_ctl_m0_d0.decoded_imm_j)!=btb_ctl_m0_d0.tgt);
+          btb_upd_v_d1_o      <= dir_miss_m0;
           btb_upd_d1_o.valid  <= 1;
-          btb_upd_d1_o.pc     <= btb_ctl_m0_d0.pc;
-          btb_upd_d1_o.tgt    <= btb_ctl_m0_d0.pc + uop_ctl_m0_d0.decoded_imm_j;
-          is_branch_d1_o[0]   <= ~btb_ctl_m0_d0.jump| 
-                                ((btb_ctl_m0_d0.pc + uop_ctl_m0_d0.decoded_imm_j)!=btb_ctl_m0_d0.tgt);
+          btb_upd_d1_o.pc     <= end_pc_m0;
+          btb_upd_d1_o.tgt    <= dir_tgt_m0;
+          btb_upd_d1_o.is_br  <= br_tkn_m0;
+          btb_upd_d1_o.is_call<= uop_ctl_m0_d0.instr_jal & rd_is_link_m0;
+          btb_upd_d1_o.hit_mbtb <= btb_ctl_m0_d0.hit_mbtb;
+          btb_upd_d1_o.way_mbtb <= btb_ctl_m0_d0.way_mbtb;
+          ras_fix_d1_o.push   <= uop_ctl_m0_d0.instr_jal & rd_is_link_m0;
+          ras_fix_d1_o.pop    <= 1'b0;
+          ras_fix_d1_o.ras_ptr<= btb_ctl_m0_d0.ras_ptr;
+          ras_fix_d1_o.ras_top<= btb_ctl_m0_d0.ras_top;
+          ras_fix_d1_o.ret_pc <= end_pc_m0 + 32'd2;
+          ras_fix_d1_o.lp_cnt <= btb_ctl_m0_d0.lp_cnt;
+          redirect_d1         <= dir_miss_m0;
         end
       end
     end
 
-    if(flush_i) begin
+    if(flush_i | redirect_d1_o) begin
       iq_rd_ptr               <= iq_prefetch_ptr;
+    `ifdef ENABLE_RVC
+      iq_rd_half              <= 1'b0;
+    `endif
     end
   end
 
@@ -197,7 +288,7 @@ module N2_idu_decode #(
                           uop_ctl_m1_d0.decoded_rd  != uop_ctl_m0_d0.decoded_rd |
                           uop_ctl_m0_d0.decoded_rd  == 0;
   wire is_branch_instr0 = uop_ctl_m0_d0.instr_retirq | uop_ctl_m0_d0.instr_jal | uop_ctl_m0_d0.instr_jalr |
-                          uop_ctl_m0_d0.is_beq_bne_blt_bge_bltu_bgeu;
+                          uop_ctl_m0_d0.is_beq_bne_blt_bge_bltu_bgeu | uop_ctl_m0_d0.is_hwlp;
   wire [2:0] bm_ex0, bm_ex1;
   assign bm_ex0 = { uop_ctl_m0_d0.is_rdcycle_rdcycleh_rdinstr_rdinstrh | uop_ctl_m0_d0.instr_maskirq |
                         uop_ctl_m0_d0.instr_retirq | uop_ctl_m0_d0.instr_jal,
@@ -208,18 +299,32 @@ module N2_idu_decode #(
                         uop_ctl_m1_d0.is_lb_lh_lw_lbu_lhu | uop_ctl_m1_d0.is_sb_sh_sw,
                         uop_ctl_m1_d0.instr_any_div_rem | uop_ctl_m1_d0.instr_any_mul};
   wire no_ex_conflict   = ~(|(bm_ex0 & bm_ex1));
-  assign allow_instr1   = no_data_conflict & no_ex_conflict & ~is_branch_instr0;
+  //* hpm csr & lp.* are only issued as instr0;
+  assign allow_instr1   = no_data_conflict & no_ex_conflict & ~is_branch_instr0 &
+                          ~uop_ctl_m1_d0.is_csr_hpm & ~uop_ctl_m1_d0.is_hwlp & ~retirq_m1;
 
+`ifdef ENABLE_RVC
+  //* fifo used to store raw instr, realigned/expanded/pre-decoded at read;
+  iq_data_t iq_entry[7:0];
+`else
   //* fifo used to store pre-decoded instr;
   uop_ctl_t iq_entry[7:0];
+`endif
   assign iq_rd_ptr_o = iq_rd_ptr;
   reg tag_wait_wr;
+`ifdef ENABLE_RVC
+  assign iq_not_empty_m0 = rvc_v_m0;
+  assign iq_bypass_m0 = 1'b0;
+  assign iq_not_empty_m1 = rvc_v_m1;
+  assign iq_bypass_m1 = 1'b0;
+`else
   assign iq_not_empty_m0 = ~tag_wait_wr & (iq_rd_ptr != iq_wr_ptr);
   assign iq_bypass_m0 = ~tag_wait_wr & (iq_rd_ptr == iq_wr_ptr) & uop_ctl_v_ifu_i[0];
   
   assign iq_not_empty_m1 = iq_not_empty_m0 & (iq_rd_ptr_nxt != iq_wr_ptr);
   assign iq_bypass_m1 = ~tag_wait_wr & ((iq_rd_ptr == iq_wr_ptr) & uop_ctl_v_ifu_i[1] |
                                             (iq_rd_ptr_nxt == iq_wr_ptr) & uop_ctl_v_ifu_i[0]);
+`endif
 
   wire [2:0] iq_wr_ptr_inc1 = 3'd1 + iq_wr_ptr;
   wire [2:0] iq_wr_ptr_inc2 = 3'd2 + iq_wr_ptr;
@@ -235,7 +340,11 @@ module N2_idu_decode #(
         for(integer idx=0; idx<8; idx=idx+1) begin
           if((idx == iq_wr_ptr) & uop_ctl_v_ifu_i[0] |
              (idx == iq_wr_ptr_inc1) & uop_ctl_v_ifu_i[1])
+            `ifdef ENABLE_RVC
+              iq_entry[idx] <= (idx == iq_wr_ptr)? instr_rdata_ifu_i[31:0]: instr_rdata_ifu_i[63:32];
+            `else
               iq_entry[idx] <= (idx == iq_wr_ptr)? uop_ctl_m0_ifu_i: uop_ctl_m1_ifu_i;
+            `endif
         end
       end
       if(uop_ctl_v_ifu_i == 2'b1) begin
@@ -249,36 +358,38 @@ module N2_idu_decode #(
           tag_wait_wr   <= 1'b0;
       end
       //* wait new instr
-      if(flush_i) begin
+      if(flush_i | redirect_d1_o) begin
         tag_wait_wr     <= 1'b1;
       end
     end
   end
 
+`ifndef ENABLE_RVC
   always_comb begin
     case({iq_bypass_m0,iq_rd_ptr})
-      {1'b0,3'd0}: uop_ctl_m0_d0 = iq_entry[0];
-      {1'b0,3'd1}: uop_ctl_m0_d0 = iq_entry[1];
-      {1'b0,3'd2}: uop_ctl_m0_d0 = iq_entry[2];
-      {1'b0,3'd3}: uop_ctl_m0_d0 = iq_entry[3];
-      {1'b0,3'd4}: uop_ctl_m0_d0 = iq_entry[4];
-      {1'b0,3'd5}: uop_ctl_m0_d0 = iq_entry[5];
-      {1'b0,3'd6}: uop_ctl_m0_d0 = iq_entry[6];
-      {1'b0,3'd7}: uop_ctl_m0_d0 = iq_entry[7];
-      default:     uop_ctl_m0_d0 = uop_ctl_m0_ifu_i;     
+      {1'b0,3'd0}: uop_raw_m0_d0 = iq_entry[0];
+      {1'b0,3'd1}: uop_raw_m0_d0 = iq_entry[1];
+      {1'b0,3'd2}: uop_raw_m0_d0 = iq_entry[2];
+      {1'b0,3'd3}: uop_raw_m0_d0 = iq_entry[3];
+      {1'b0,3'd4}: uop_raw_m0_d0 = iq_entry[4];
+      {1'b0,3'd5}: uop_raw_m0_d0 = iq_entry[5];
+      {1'b0,3'd6}: uop_raw_m0_d0 = iq_entry[6];
+      {1'b0,3'd7}: uop_raw_m0_d0 = iq_entry[7];
+      default:     uop_raw_m0_d0 = uop_ctl_m0_ifu_i;     
     endcase
     case({iq_bypass_m1,iq_rd_ptr_nxt})
-      {1'b0,3'd0}: uop_ctl_m1_d0 = iq_entry[0];
-      {1'b0,3'd1}: uop_ctl_m1_d0 = iq_entry[1];
-      {1'b0,3'd2}: uop_ctl_m1_d0 = iq_entry[2];
-      {1'b0,3'd3}: uop_ctl_m1_d0 = iq_entry[3];
-      {1'b0,3'd4}: uop_ctl_m1_d0 = iq_entry[4];
-      {1'b0,3'd5}: uop_ctl_m1_d0 = iq_entry[5];
-      {1'b0,3'd6}: uop_ctl_m1_d0 = iq_entry[6];
-      {1'b0,3'd7}: uop_ctl_m1_d0 = iq_entry[7];
-      default:     uop_ctl_m1_d0 = (iq_rd_ptr == iq_wr_ptr)? uop_ctl_m1_ifu_i: uop_ctl_m0_ifu_i;     
+      {1'b0,3'd0}: uop_raw_m1_d0 = iq_entry[0];
+      {1'b0,3'd1}: uop_raw_m1_d0 = iq_entry[1];
+      {1'b0,3'd2}: uop_raw_m1_d0 = iq_entry[2];
+      {1'b0,3'd3}: uop_raw_m1_d0 = iq_entry[3];
+      {1'b0,3'd4}: uop_raw_m1_d0 = iq_entry[4];
+      {1'b0,3'd5}: uop_raw_m1_d0 = iq_entry[5];
+      {1'b0,3'd6}: uop_raw_m1_d0 = iq_entry[6];
+      {1'b0,3'd7}: uop_raw_m1_d0 = iq_entry[7];
+      default:     uop_raw_m1_d0 = (iq_rd_ptr == iq_wr_ptr)? uop_ctl_m1_ifu_i: uop_ctl_m0_ifu_i;     
     endcase
   end
+`endif
 
 
   `ifdef ENABLE_BP
@@ -307,8 +418,18 @@ module N2_idu_decode #(
       pc_m0_d1_o              <= btb_ctl_m0_d0.pc;
       btb_ctl_m1_d1_o         <= btb_ctl_m1_d0;
       pc_m1_d1_o              <= btb_ctl_m1_d0.pc;
+      //* static predicted taken;
+      if(br_tkn_m0) begin
+        btb_ctl_m0_d1_o.jump  <= 1'b1;
+        btb_ctl_m0_d1_o.tgt   <= dir_tgt_m0;
+      end
+      if(br_tkn_m1) begin
+        btb_ctl_m1_d1_o.jump  <= 1'b1;
+        btb_ctl_m1_d1_o.tgt   <= dir_tgt_m1;
+      end
     end
 
+  `ifndef ENABLE_RVC
     always_comb begin
       (*full_case, parallel_case*)
       case({iq_bypass_m0,iq_rd_ptr})
@@ -336,6 +457,113 @@ module N2_idu_decode #(
       endcase
     end
   `endif
+  `endif
+
+`ifdef ENABLE_RVC
+  //* read window: 3 words from iq_rd_ptr, words not in iq yet are bypassed from ifu;
+  wire  [2:0]   iq_used = iq_wr_ptr - iq_rd_ptr;
+  wire  [2:0]   win_cnt = tag_wait_wr? 3'd0: (iq_used + {1'b0,uop_ctl_v_ifu_i[1],
+                                                   uop_ctl_v_ifu_i[0] & ~uop_ctl_v_ifu_i[1]});
+  iq_data_t     win_word[2:0];
+  btb_ctl_t     win_bp[2:0];
+  logic [5:0][15:0] win_half;
+  always_comb begin
+    for(integer k=0; k<3; k=k+1) begin
+      win_word[k]     = iq_entry[3'(iq_rd_ptr + k)];
+      win_bp[k]       = bpiq_entry[3'(iq_rd_ptr + k)];
+      if(k == iq_used) begin
+        win_word[k]   = instr_rdata_ifu_i[31:0];
+        win_bp[k]     = btb_ctl_m0_i;
+      end
+      else if(k == iq_used + 1) begin
+        win_word[k]   = instr_rdata_ifu_i[63:32];
+        win_bp[k]     = btb_ctl_m1_i;
+      end
+      win_half[2*k]   = win_word[k].opcode[15:0];
+      win_half[2*k+1] = win_word[k].opcode[31:16];
+    end
+  end
+
+  //* realign: s0/e0 (e1) is the first/last halfword of instr0 (instr1);
+  logic [2:0]   rvc_s0, rvc_e0, rvc_e1;
+  logic         rvc_32b_m0, rvc_32b_m1, rvc_jump_m0, rvc_jump_m1;
+  always_comb begin
+    //* fetch after redirect may start at the upper halfword;
+    rvc_s0      = {2'b0, iq_rd_half | win_bp[0].pc[1]};
+    rvc_32b_m0  = &win_half[rvc_s0][1:0];
+    rvc_e0      = rvc_s0 + {2'b0, rvc_32b_m0};
+    //* jump is predicted for the instr ending at jmp_half, skip the rest of word;
+    rvc_jump_m0 = win_bp[rvc_e0[2:1]].jump & (win_bp[rvc_e0[2:1]].jmp_half == rvc_e0[0]);
+    rvc_v_m0    = win_cnt > {1'b0, rvc_e0[2:1]};
+    rvc_p1      = rvc_jump_m0? {rvc_e0[2:1] + 2'd1, 1'b0}: (rvc_e0 + 3'd1);
+
+    rvc_32b_m1  = &win_half[rvc_p1][1:0];
+    rvc_e1      = rvc_p1 + {2'b0, rvc_32b_m1};
+    rvc_jump_m1 = win_bp[rvc_e1[2:1]].jump & (win_bp[rvc_e1[2:1]].jmp_half == rvc_e1[0]);
+    rvc_v_m1    = ~rvc_jump_m0 & (win_cnt > {1'b0, rvc_e1[2:1]});
+    rvc_p2      = rvc_jump_m1? {rvc_e1[2:1] + 2'd1, 1'b0}: (rvc_e1 + 3'd1);
+  end
+
+  //* expand & pre-decode;
+  wire  [31:0]  instr_exp_m0, instr_exp_m1;
+  N2_idu_rvc N2_idu_rvc_i0(
+    .instr_c_i        (win_half[rvc_s0]     ),
+    .instr_o          (instr_exp_m0         )
+  );
+  N2_idu_rvc N2_idu_rvc_i1(
+    .instr_c_i        (win_half[rvc_p1]     ),
+    .instr_o          (instr_exp_m1         )
+  );
+  wire  [31:0]  instr_m0_d0 = rvc_32b_m0? {win_half[rvc_e0], win_half[rvc_s0]}: instr_exp_m0;
+  wire  [31:0]  instr_m1_d0 = rvc_32b_m1? {win_half[rvc_e1], win_half[rvc_p1]}: instr_exp_m1;
+  uop_ctl_t     uop_pre_m0, uop_pre_m1, uop_ext_m0, uop_ext_m1;
+  N2_idu_predecode N2_idu_predecode_i0(
+    .instr_rdata_i    (instr_m0_d0          ),
+    .uop_ctl          (uop_pre_m0           )
+  );
+  N2_idu_predecode N2_idu_predecode_i1(
+    .instr_rdata_i    (instr_m1_d0          ),
+    .uop_ctl          (uop_pre_m1           )
+  );
+  N2_idu_decode_ext N2_idu_decode_ext_i0(
+    .instr_rdata_i    (instr_m0_d0          ),
+    .uop_ctl_i        (uop_pre_m0           ),
+    .uop_ctl_o        (uop_ext_m0           )
+  );
+  N2_idu_decode_ext N2_idu_decode_ext_i1(
+    .instr_rdata_i    (instr_m1_d0          ),
+    .uop_ctl_i        (uop_pre_m1           ),
+    .uop_ctl_o        (uop_ext_m1           )
+  );
+
+  //* btb_ctl of the word holding the last halfword, with pc of this instr;
+  always_comb begin
+    uop_raw_m0_d0         = uop_ext_m0;
+    uop_raw_m0_d0.is_rvc  = ~rvc_32b_m0;
+    uop_raw_m1_d0         = uop_ext_m1;
+    uop_raw_m1_d0.is_rvc  = ~rvc_32b_m1;
+    btb_ctl_m0_d0         = win_bp[rvc_e0[2:1]];
+    btb_ctl_m0_d0.pc      = {win_bp[0].pc[31:2], rvc_s0[0], 1'b0};
+    btb_ctl_m0_d0.jump    = rvc_jump_m0;
+    btb_ctl_m1_d0         = win_bp[rvc_e1[2:1]];
+    btb_ctl_m1_d0.pc      = {win_bp[rvc_p1[2:1]].pc[31:2], rvc_p1[0], 1'b0};
+    btb_ctl_m1_d0.jump    = rvc_jump_m1;
+  end
+`endif
+
+  //* macro-op fusion, instr1 of a fused pair is issued as nop;
+`ifdef ENABLE_BP
+  wire          fuse_v_m1 = (iq_not_empty_m1 | iq_bypass_m1) & ~btb_ctl_m0_d0.jump & ~btb_ctl_m1_d0.jump;
+`else
+  wire          fuse_v_m1 = iq_not_empty_m1 | iq_bypass_m1;
+`endif
+  N2_idu_fuse N2_idu_fuse(
+    .uop_ctl_m0_i     (uop_raw_m0_d0        ),
+    .uop_ctl_m1_i     (uop_raw_m1_d0        ),
+    .uop_ctl_m1_v_i   (fuse_v_m1            ),
+    .uop_ctl_m0_o     (uop_ctl_m0_d0        ),
+    .uop_ctl_m1_o     (uop_ctl_m1_d0        )
+  );
 
   always @(posedge clk or negedge resetn) begin
     if(!resetn) begin
@@ -352,45 +580,62 @@ module N2_idu_decode #(
   reg   [31:0]  scb_ready_delay_1, scb_ready_delay_2;
   reg   wait_lsu, wait_mu;
   reg   [2:1] wait_mu_delay;
+  //* lsq full only stalls ld/st, a late load (ld_late_i) only stalls the 
+  //*   instrs reading/writing its rd;
+  wire  [31:0]  ld_late_msk = ld_late_i? (32'b1 << ld_late_dst_i): 32'b0;
+`ifdef ENABLE_IRQ_SHADOW
+  always_comb begin
+    scb_idle = 1'b1;
+    for(integer i=1; i<32; i=i+1)
+      scb_idle = scb_idle & scb[i].ready;
+  end
+`endif
   always_comb begin
-    stall_scb_m0 = wait_mu & (uop_ctl_m0_d0.instr_any_div_rem) | lsu_stall_idu_i;
+    stall_scb_m0 = wait_mu & (uop_ctl_m0_d0.instr_any_div_rem) | 
+                    lsu_stall_idu_i & (uop_ctl_m0_d0.is_lb_lh_lw_lbu_lhu | uop_ctl_m0_d0.is_sb_sh_sw) |
+                    ~scb_idle & (uop_ctl_m0_d0.instr_retirq | ~irq_processing_i & (|irq_offset_i));
     for(integer i=1; i<32; i=i+1) begin
       if(uop_ctl_m0_d0.decoded_rs1 == i || uop_ctl_m0_d0.decoded_rs2 == i)
-        stall_scb_m0 = stall_scb_m0 | (~scb[i].ready & ~scb[i].stage[0] &
+        stall_scb_m0 = stall_scb_m0 | ld_late_msk[i] | (~scb[i].ready & ~scb[i].stage[0] &
                         (~scb[i].stage[1] | 
                           uop_ctl_m0_d0.is_lb_lh_lw_lbu_lhu |
-                          uop_ctl_m0_d0.is_sb_sh_sw));
+                          uop_ctl_m0_d0.is_sb_sh_sw | uop_ctl_m0_d0.is_csr_hpm |
+                          uop_ctl_m0_d0.is_hwlp));
       if(uop_ctl_m0_d0.decoded_rd == i)
         // stall_scb_m0 = stall_scb_m0 | ~scb[i].ready;
-        stall_scb_m0 = stall_scb_m0 | (~scb[i].ready & ((scb[i].stage[1:0] == 2'b0) |
+        stall_scb_m0 = stall_scb_m0 | ld_late_msk[i] | (~scb[i].ready & ((scb[i].stage[1:0] == 2'b0) |
                         uop_ctl_m0_d0.is_rdcycle_rdcycleh_rdinstr_rdinstrh | uop_ctl_m0_d0.instr_maskirq |
-                        uop_ctl_m0_d0.instr_retirq | uop_ctl_m0_d0.instr_jal));
+                        uop_ctl_m0_d0.instr_retirq | uop_ctl_m0_d0.instr_jal | uop_ctl_m0_d0.is_csr_hpm));
     end
 
-    stall_scb_m1 = wait_mu & (uop_ctl_m1_d0.instr_any_div_rem) | lsu_stall_idu_i;
+    stall_scb_m1 = wait_mu & (uop_ctl_m1_d0.instr_any_div_rem) | 
+                    lsu_stall_idu_i & (uop_ctl_m1_d0.is_lb_lh_lw_lbu_lhu | uop_ctl_m1_d0.is_sb_sh_sw);
     for(integer i=1; i<32; i=i+1) begin
       if(uop_ctl_m1_d0.decoded_rs1 == i || uop_ctl_m1_d0.decoded_rs2 == i)
         // stall_scb_m1 = stall_scb_m1 | (~scb[i].ready & ~scb[i].stage[0]);
-        stall_scb_m1 = stall_scb_m1 | (~scb[i].ready & ~scb[i].stage[0] &
+        stall_scb_m1 = stall_scb_m1 | ld_late_msk[i] | (~scb[i].ready & ~scb[i].stage[0] &
                         (~scb[i].stage[1] | 
                           uop_ctl_m1_d0.is_lb_lh_lw_lbu_lhu |
                           uop_ctl_m1_d0.is_sb_sh_sw));
       if(uop_ctl_m1_d0.decoded_rd == i)
-        stall_scb_m1 = stall_scb_m1 | ~scb[i].ready;
+        stall_scb_m1 = stall_scb_m1 | ld_late_msk[i] | ~scb[i].ready;
     end
   end
 
   always_ff @(posedge clk or negedge resetn) begin
     scb_ready_delay_2   <= scb_ready_delay_1;
     wait_mu_delay[2:1]  <= {wait_mu_delay[1],wait_mu};
+    //* a parked late load is not ready until its writeback (rf_we_lsu_i),
+    //*   rf_we_lsu_ns_i is raised while it waits at the lsq head;
     for(integer i=0; i<32; i=i+1)
-      scb_ready_delay_1[i] <= scb[i].ready | scb[i].temp_ready;
+      scb_ready_delay_1[i] <= scb[i].ready | scb[i].temp_ready & ~scb[i].late;
 
     if(~resetn) begin
       for(integer i=0; i<32; i=i+1) begin
         scb[i].ready    <= 1'b1;
         scb[i].alu      <= 'b0;
         scb[i].stage    <= 'b0;
+        scb[i].late     <= 'b0;
       end
       wait_mu           <= 1'b0;
     end 
@@ -398,12 +643,13 @@ module N2_idu_decode #(
       //* clear prefetched instr;
       if(is_branch_d2_i) begin
         for(integer i=0; i<32; i=i+1)
-          scb[i].ready  <= scb_ready_delay_1[i] | scb[i].ready | scb[i].temp_ready;
+          scb[i].ready  <= scb[i].ready | ~scb[i].late & (scb_ready_delay_1[i] | scb[i].temp_ready);
         wait_mu         <= wait_mu_delay[1] & wait_mu;
       end
       if(is_branch_ex_i) begin
         for(integer i=0; i<32; i=i+1)
-          scb[i].ready  <= scb_ready_delay_2[i] | scb_ready_delay_1[i] | scb[i].ready | scb[i].temp_ready;
+          scb[i].ready  <= scb[i].ready | ~scb[i].late & (scb_ready_delay_2[i] | 
+                            scb_ready_delay_1[i] | scb[i].temp_ready);
         wait_mu         <= wait_mu_delay[2] & wait_mu_delay[1] & wait_mu;
       end
 
@@ -414,24 +660,36 @@ module N2_idu_decode #(
             i == rf_dst_ex1_i && rf_we_ex1_i && (scb[i].stage == 3'b1 || flush_i) ||
             // i == rf_dst_lsu_i && rf_we_lsu_i && scb[i].stage == 3'b0 ||
             i == rf_dst_mu_i && rf_we_mu_i ||
-            i == rf_dst_lsu_ns_i && rf_we_lsu_ns_i && (scb[i].stage == 3'b1 || flush_i))
+            i == rf_dst_lsu_ns_i && rf_we_lsu_ns_i && ~scb[i].late && (scb[i].stage == 3'b1 || flush_i))
           scb[i].ready  <= 1'b1;
+      //* late load is ready at writeback;
+      for(integer i=1; i<32; i=i+1)
+        if(i == rf_dst_lsu_i && rf_we_lsu_i && scb[i].late) begin
+          scb[i].ready  <= 1'b1;
+          scb[i].late   <= 1'b0;
+        end
       for(integer i=1; i<32; i=i+1)
         if( i == rf_dst_idu_i && rf_we_idu_i ||
             i == rf_dst_ex0_i && rf_we_ex0_i ||
             i == rf_dst_ex1_i && rf_we_ex1_i ||
             // i == rf_dst_lsu_i && rf_we_lsu_i ||
             i == rf_dst_mu_i && rf_we_mu_i ||
-            i == rf_dst_lsu_ns_i && rf_we_lsu_ns_i)
+            i == rf_dst_lsu_ns_i && rf_we_lsu_ns_i && ~scb[i].late)
           scb[i].temp_ready  <= 1'b1;
         else
           scb[i].temp_ready  <= 1'b0;
 
       for(integer i=1; i<32; i=i+1)
         scb[i].stage <= {1'b0,scb[i].stage[2:1]};
+      //* park late load, no bypass from lsu;
+      for(integer i=1; i<32; i=i+1)
+        if(ld_late_msk[i]) begin
+          scb[i].stage  <= 'b0;
+          scb[i].late   <= 1'b1;
+        end
 
       if(~stall_scb_m0 && (iq_not_empty_m0 |iq_bypass_m0) && ~flush_i && ~(|is_branch_d1_o) && 
-              (irq_processing_i || !irq_offset_i)) 
+              ~redirect_d1 && (irq_processing_i || !irq_offset_i)) 
       begin
         for(integer i=1; i<32; i=i+1)
           if(i == uop_ctl_m0_d0.decoded_rd) begin
@@ -443,7 +701,8 @@ module N2_idu_decode #(
             scb[i].stage[1] <= ~(uop_ctl_m0_d0.is_beq_bne_blt_bge_bltu_bgeu | 
                                 uop_ctl_m0_d0.is_sb_sh_sw | uop_ctl_m0_d0.is_lb_lh_lw_lbu_lhu |
                                 uop_ctl_m0_d0.instr_any_div_rem | uop_ctl_m0_d0.instr_any_mul |
-                                uop_ctl_m0_d0.instr_maskirq | uop_ctl_m0_d0.instr_retirq);
+                                uop_ctl_m0_d0.instr_maskirq | uop_ctl_m0_d0.instr_retirq |
+                                uop_ctl_m0_d0.is_csr_hpm);
             scb[i].stage[2] <= uop_ctl_m0_d0.is_lb_lh_lw_lbu_lhu;
           end
         wait_mu             <= uop_ctl_m0_d0.instr_any_div_rem | wait_mu;
@@ -459,7 +718,8 @@ module N2_idu_decode #(
               scb[i].stage[1] <= ~(uop_ctl_m0_d0.is_beq_bne_blt_bge_bltu_bgeu | 
                                   uop_ctl_m0_d0.is_sb_sh_sw | uop_ctl_m0_d0.is_lb_lh_lw_lbu_lhu |
                                   uop_ctl_m0_d0.instr_any_div_rem | uop_ctl_m0_d0.instr_any_mul |
-                                  uop_ctl_m0_d0.instr_maskirq | uop_ctl_m0_d0.instr_retirq);
+                                  uop_ctl_m0_d0.instr_maskirq | uop_ctl_m0_d0.instr_retirq |
+                                  uop_ctl_m0_d0.is_csr_hpm);
               scb[i].stage[2] <= uop_ctl_m0_d0.is_lb_lh_lw_lbu_lhu;
             end
             else if(i == uop_ctl_m1_d0.decoded_rd) begin
@@ -471,7 +731,8 @@ module N2_idu_decode #(
               scb[i].stage[1] <= ~(uop_ctl_m1_d0.is_beq_bne_blt_bge_bltu_bgeu | 
                                   uop_ctl_m1_d0.is_sb_sh_sw | uop_ctl_m1_d0.is_lb_lh_lw_lbu_lhu |
                                   uop_ctl_m1_d0.instr_any_div_rem | uop_ctl_m1_d0.instr_any_mul |
-                                  uop_ctl_m1_d0.instr_maskirq | uop_ctl_m1_d0.instr_retirq);
+                                  uop_ctl_m1_d0.instr_maskirq | uop_ctl_m1_d0.instr_retirq |
+                                  uop_ctl_m1_d0.is_csr_hpm);
               scb[i].stage[2] <= uop_ctl_m1_d0.is_lb_lh_lw_lbu_lhu;
             end
           wait_mu             <= uop_ctl_m0_d0.instr_any_div_rem | uop_ctl_m1_d0.instr_any_div_rem | wait_mu;
@@ -482,4 +743,233 @@ module N2_idu_decode #(
     end
   end
 
-endmodule
\ No newline at end of file
+endmodule
+//* decode extensions on the output of N2_idu_predecode:
+//*   1) Zba/Zbb/Zbc, all zb fields are '0 without ENABLE_ZB/ENABLE_ZBC;
+//*   2) csrrw/csrrs/csrrc on mhpmevent3~, mhpmcounter3~(h) & hpmcounter3~(h),
+//*     all csr fields are '0 without ENABLE_HPM;
+//*   3) csum.add/csum.fold in custom-0 (funct7 is 0001000/0001001, funct3 is 000),
+//*     all csum fields are '0 without ENABLE_XCSUM;
+//*   4) lp.* in custom-3 (funct3 is op, rd is level), all hwlp fields are '0 
+//*     without ENABLE_HWLOOP;
+//*   5) RV32A (lr.w/sc.w/amo*.w), decoded as lw with is_amo & amo_op (funct5),
+//*     aq/rl are ignored as lsu is in order; all amo fields are '0 without ENABLE_ATOMIC;
+module N2_idu_decode_ext (
+  input   wire  [31:0]  instr_rdata_i,
+  input   uop_ctl_t     uop_ctl_i,
+  output  uop_ctl_t     uop_ctl_o
+);
+  wire  [31:0]  i       = instr_rdata_i;
+  wire          is_op   = (i[6:0] == 7'b0110011);
+  wire          is_opi  = (i[6:0] == 7'b0010011);
+  wire  [2:0]   funct3  = i[14:12];
+  wire  [6:0]   funct7  = i[31:25];
+  wire  [11:0]  funct12 = i[31:20];
+  //* csr[11:5]: 0x19 is mhpmevent, 0x58/0x5c is mhpmcounter(h), 0x60/0x64 is hpmcounter(h);
+  wire  [11:0]  csr     = i[31:20];
+  wire          is_csr  = (i[6:0] == 7'b1110011) & (funct3[2] == 1'b0) & (funct3[1:0] != 2'b0);
+  wire          is_hpm  = (csr[11:5] == 7'h19) | (csr[11:5] == 7'h58) | (csr[11:5] == 7'h5c) |
+                          (csr[11:5] == 7'h60) | (csr[11:5] == 7'h64);
+  wire          hpm_idx = (csr[4:0] >= 5'd3) & (csr[4:0] < 5'(3 + `HPM_NUM));
+  wire          is_cus0 = (i[6:0] == 7'b0001011) & (funct3 == 3'b000);
+  wire          is_cus3 = (i[6:0] == 7'b1111011) & (i[11:8] == 4'b0) & (funct3 <= 3'b101);
+  wire  [4:0]   funct5  = i[31:27];
+  wire          is_amo  = (i[6:0] == 7'b0101111) & (funct3 == 3'b010) &
+                          ((funct5 == AMO_LR) | (funct5 == AMO_SC) | (funct5[1:0] == 2'b0) |
+                           (funct5 == 5'b00001));
+
+  always_comb begin
+    uop_ctl_o               = uop_ctl_i;
+  `ifdef ENABLE_ZB
+    uop_ctl_o.instr_sh1add  = is_op  & (funct7 == 7'b0010000) & (funct3 == 3'b010);
+    uop_ctl_o.instr_sh2add  = is_op  & (funct7 == 7'b0010000) & (funct3 == 3'b100);
+    uop_ctl_o.instr_sh3add  = is_op  & (funct7 == 7'b0010000) & (funct3 == 3'b110);
+    uop_ctl_o.instr_andn    = is_op  & (funct7 == 7'b0100000) & (funct3 == 3'b111);
+    uop_ctl_o.instr_orn     = is_op  & (funct7 == 7'b0100000) & (funct3 == 3'b110);
+    uop_ctl_o.instr_xnor    = is_op  & (funct7 == 7'b0100000) & (funct3 == 3'b100);
+    uop_ctl_o.instr_min     = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b100);
+    uop_ctl_o.instr_minu    = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b101);
+    uop_ctl_o.instr_max     = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b110);
+    uop_ctl_o.instr_maxu    = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b111);
+    uop_ctl_o.instr_rol     = is_op  & (funct7 == 7'b0110000) & (funct3 == 3'b001);
+    uop_ctl_o.instr_zext_h  = is_op  & (funct12== 12'h080)    & (funct3 == 3'b100);
+    uop_ctl_o.instr_clz     = is_opi & (funct12== 12'h600)    & (funct3 == 3'b001);
+    uop_ctl_o.instr_ctz     = is_opi & (funct12== 12'h601)    & (funct3 == 3'b001);
+    uop_ctl_o.instr_cpop    = is_opi & (funct12== 12'h602)    & (funct3 == 3'b001);
+    uop_ctl_o.instr_sext_b  = is_opi & (funct12== 12'h604)    & (funct3 == 3'b001);
+    uop_ctl_o.instr_sext_h  = is_opi & (funct12== 12'h605)    & (funct3 == 3'b001);
+    uop_ctl_o.instr_rev8    = is_opi & (funct12== 12'h698)    & (funct3 == 3'b101);
+    uop_ctl_o.instr_orc_b   = is_opi & (funct12== 12'h287)    & (funct3 == 3'b101);
+    uop_ctl_o.instr_ror     = (is_op | is_opi) & (funct7 == 7'b0110000) & (funct3 == 3'b101);
+    uop_ctl_o.is_zb_imm     = is_opi & (uop_ctl_o.instr_ror  | uop_ctl_o.instr_clz  | 
+                                        uop_ctl_o.instr_ctz  | uop_ctl_o.instr_cpop | 
+                                        uop_ctl_o.instr_sext_b | uop_ctl_o.instr_sext_h |
+                                        uop_ctl_o.instr_rev8 | uop_ctl_o.instr_orc_b);
+    uop_ctl_o.is_zb         = uop_ctl_o.is_zb_imm | uop_ctl_o.instr_sh1add | uop_ctl_o.instr_sh2add |
+                              uop_ctl_o.instr_sh3add | uop_ctl_o.instr_andn | uop_ctl_o.instr_orn |
+                              uop_ctl_o.instr_xnor | uop_ctl_o.instr_min | uop_ctl_o.instr_minu |
+                              uop_ctl_o.instr_max | uop_ctl_o.instr_maxu | uop_ctl_o.instr_rol |
+                              uop_ctl_o.instr_ror | uop_ctl_o.instr_zext_h;
+    //* not supported by predecode;
+    if(uop_ctl_o.is_zb)
+      uop_ctl_o.instr_trap  = 1'b0;
+  `else
+    {uop_ctl_o.instr_sh1add, uop_ctl_o.instr_sh2add, uop_ctl_o.instr_sh3add,
+     uop_ctl_o.instr_andn, uop_ctl_o.instr_orn, uop_ctl_o.instr_xnor,
+     uop_ctl_o.instr_clz, uop_ctl_o.instr_ctz, uop_ctl_o.instr_cpop,
+     uop_ctl_o.instr_min, uop_ctl_o.instr_minu, uop_ctl_o.instr_max, uop_ctl_o.instr_maxu,
+     uop_ctl_o.instr_rol, uop_ctl_o.instr_ror, uop_ctl_o.instr_sext_b, uop_ctl_o.instr_sext_h,
+     uop_ctl_o.instr_zext_h, uop_ctl_o.instr_rev8, uop_ctl_o.instr_orc_b,
+     uop_ctl_o.is_zb, uop_ctl_o.is_zb_imm} = '0;
+  `endif
+
+  `ifdef ENABLE_ZBC
+    uop_ctl_o.instr_clmul   = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b001);
+    uop_ctl_o.instr_clmulr  = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b010);
+    uop_ctl_o.instr_clmulh  = is_op  & (funct7 == 7'b0000101) & (funct3 == 3'b011);
+    //* issued to mu as a mul;
+    if(uop_ctl_o.instr_clmul | uop_ctl_o.instr_clmulr | uop_ctl_o.instr_clmulh) begin
+      uop_ctl_o.instr_any_mul = 1'b1;
+      uop_ctl_o.instr_trap  = 1'b0;
+    end
+  `else
+    {uop_ctl_o.instr_clmul, uop_ctl_o.instr_clmulh, uop_ctl_o.instr_clmulr} = '0;
+  `endif
+
+  `ifdef ENABLE_HPM
+    uop_ctl_o.is_csr_hpm    = is_csr & is_hpm & hpm_idx;
+    uop_ctl_o.instr_csrrw   = uop_ctl_o.is_csr_hpm & (funct3[1:0] == 2'b01);
+    uop_ctl_o.instr_csrrs   = uop_ctl_o.is_csr_hpm & (funct3[1:0] == 2'b10);
+    uop_ctl_o.instr_csrrc   = uop_ctl_o.is_csr_hpm & (funct3[1:0] == 2'b11);
+    if(uop_ctl_o.is_csr_hpm) begin
+      uop_ctl_o.decoded_imm = {20'b0, csr};
+      uop_ctl_o.decoded_rs2 = '0;
+      uop_ctl_o.instr_trap  = 1'b0;
+    end
+  `else
+    {uop_ctl_o.instr_csrrw, uop_ctl_o.instr_csrrs, uop_ctl_o.instr_csrrc,
+     uop_ctl_o.is_csr_hpm} = '0;
+  `endif
+
+  `ifdef ENABLE_XCSUM
+    uop_ctl_o.instr_csum_add  = is_cus0 & (funct7 == 7'b0001000);
+    uop_ctl_o.instr_csum_fold = is_cus0 & (funct7 == 7'b0001001);
+    uop_ctl_o.is_csum       = uop_ctl_o.instr_csum_add | uop_ctl_o.instr_csum_fold;
+    //* custom-0 is only decoded for retirq/maskirq by predecode;
+    if(uop_ctl_o.is_csum) begin
+      uop_ctl_o.decoded_rd  = i[11:7];
+      uop_ctl_o.decoded_rs1 = i[19:15];
+      uop_ctl_o.decoded_rs2 = uop_ctl_o.instr_csum_add? i[24:20]: '0;
+      uop_ctl_o.instr_trap  = 1'b0;
+    end
+  `else
+    {uop_ctl_o.instr_csum_add, uop_ctl_o.instr_csum_fold, uop_ctl_o.is_csum} = '0;
+  `endif
+
+  `ifdef ENABLE_HWLOOP
+    uop_ctl_o.is_hwlp       = is_cus3;
+    uop_ctl_o.hwlp_op       = funct3;
+    uop_ctl_o.hwlp_level    = i[7];
+    //* imm[11:0] is uimmL, imm[16:12] is uimmS (setupi), rs1 is read by count/setup;
+    if(uop_ctl_o.is_hwlp) begin
+      uop_ctl_o.decoded_rd  = '0;
+      uop_ctl_o.decoded_rs1 = ((funct3 == 3'b010) | (funct3 == 3'b100))? i[19:15]: '0;
+      uop_ctl_o.decoded_rs2 = '0;
+      uop_ctl_o.decoded_imm = {15'b0, i[19:15], i[31:20]};
+      uop_ctl_o.instr_trap  = 1'b0;
+    end
+  `else
+    {uop_ctl_o.is_hwlp, uop_ctl_o.hwlp_op, uop_ctl_o.hwlp_level} = '0;
+  `endif
+
+  `ifdef ENABLE_ATOMIC
+    uop_ctl_o.is_amo        = is_amo;
+    uop_ctl_o.amo_op        = funct5;
+    //* address is rs1 (imm is 0), wdata is rs2;
+    if(uop_ctl_o.is_amo) begin
+      uop_ctl_o.is_lb_lh_lw_lbu_lhu = 1'b1;
+      uop_ctl_o.is_lbu_lhu_lw = 1'b1;
+      uop_ctl_o.decoded_rd  = i[11:7];
+      uop_ctl_o.decoded_rs1 = i[19:15];
+      uop_ctl_o.decoded_rs2 = (funct5 == AMO_LR)? '0: i[24:20];
+      uop_ctl_o.decoded_imm = '0;
+      uop_ctl_o.instr_trap  = 1'b0;
+    end
+  `else
+    {uop_ctl_o.is_amo, uop_ctl_o.amo_op} = '0;
+  `endif
+  end
+
+endmodule
+//* fuse adjacent instr pair into instr0, instr1 is replaced by nop (addi x0,x0,0), 
+//*   so that instret & pc of instr1 are kept:
+//*   1) lui/auipc rd,hi + addi rd,rd,lo  ->  lui/auipc rd,hi+lo;
+//*   2) slli rd,rs,1~3 + add rd,rd,rs2   ->  sh1add~sh3add rd,rs,rs2 (ENABLE_ZB);
+//*   3) add rd,rs1,rs2 + lw rd,imm(rd)   ->  lw rd,imm(rs1+rs2), i.e., is_ld_idx;
+//*   intermediate rd of instr0 must be overwritten by instr1, as only one rd is written;
+module N2_idu_fuse (
+  input   uop_ctl_t     uop_ctl_m0_i,
+  input   uop_ctl_t     uop_ctl_m1_i,
+  input   wire          uop_ctl_m1_v_i,
+  output  uop_ctl_t     uop_ctl_m0_o,
+  output  uop_ctl_t     uop_ctl_m1_o
+);
+  wire  [4:0]   rd      = uop_ctl_m0_i.decoded_rd;
+  wire  [4:0]   shamt   = uop_ctl_m0_i.decoded_rs2;
+  //* rd of instr0 is read by instr1 & overwritten by instr1;
+  wire          chain   = uop_ctl_m1_v_i & (rd != 5'd0) & (uop_ctl_m1_i.decoded_rd == rd) &
+                          ~uop_ctl_m0_i.instr_trap & ~uop_ctl_m1_i.instr_trap;
+  wire          fuse_imm= chain & (uop_ctl_m0_i.instr_lui | uop_ctl_m0_i.instr_auipc) &
+                          uop_ctl_m1_i.instr_addi & (uop_ctl_m1_i.decoded_rs1 == rd);
+  //* add is commutative, rd could be either rs1 or rs2 of add (not both);
+  wire          sh_rs1  = uop_ctl_m1_i.decoded_rs1 == rd;
+  wire          sh_rs2  = uop_ctl_m1_i.decoded_rs2 == rd;
+`ifdef ENABLE_ZB
+  wire          fuse_sh = chain & uop_ctl_m0_i.instr_slli & (shamt != 5'd0) & (shamt < 5'd4) &
+                          uop_ctl_m1_i.instr_add & (sh_rs1 ^ sh_rs2);
+`else
+  wire          fuse_sh = 1'b0; //* sh1add~sh3add is executed by zb alu;
+`endif
+  wire          fuse_ld = chain & uop_ctl_m0_i.instr_add & uop_ctl_m1_i.is_lb_lh_lw_lbu_lhu &
+                          ~uop_ctl_m1_i.is_amo & (uop_ctl_m1_i.decoded_rs1 == rd);
+
+  always_comb begin
+    uop_ctl_m0_o            = uop_ctl_m0_i;
+    uop_ctl_m0_o.is_ld_idx  = 1'b0;
+    uop_ctl_m1_o            = uop_ctl_m1_i;
+    uop_ctl_m1_o.is_ld_idx  = 1'b0;
+  `ifdef ENABLE_FUSE
+    if(fuse_imm) begin
+      uop_ctl_m0_o.decoded_imm  = uop_ctl_m0_i.decoded_imm + uop_ctl_m1_i.decoded_imm;
+    end
+    if(fuse_sh) begin
+      uop_ctl_m0_o              = uop_ctl_m1_i;
+      uop_ctl_m0_o.is_ld_idx    = 1'b0;
+      uop_ctl_m0_o.instr_add    = 1'b0;
+      uop_ctl_m0_o.is_lui_auipc_jal_jalr_addi_add_sub = 1'b0;
+      uop_ctl_m0_o.instr_sh1add = (shamt == 5'd1);
+      uop_ctl_m0_o.instr_sh2add = (shamt == 5'd2);
+      uop_ctl_m0_o.instr_sh3add = (shamt == 5'd3);
+      uop_ctl_m0_o.is_zb        = 1'b1;
+      uop_ctl_m0_o.decoded_rs1  = uop_ctl_m0_i.decoded_rs1;
+      uop_ctl_m0_o.decoded_rs2  = sh_rs1? uop_ctl_m1_i.decoded_rs2: uop_ctl_m1_i.decoded_rs1;
+    end
+    if(fuse_ld) begin
+      uop_ctl_m0_o              = uop_ctl_m1_i;
+      uop_ctl_m0_o.is_ld_idx    = 1'b1;
+      uop_ctl_m0_o.decoded_rs1  = uop_ctl_m0_i.decoded_rs1;
+      uop_ctl_m0_o.decoded_rs2  = uop_ctl_m0_i.decoded_rs2;
+    end
+    if(fuse_imm | fuse_sh | fuse_ld) begin
+      uop_ctl_m1_o              = '0;
+      uop_ctl_m1_o.opcode       = 32'h0000_0013;
+      uop_ctl_m1_o.instr_addi   = 1'b1;
+      uop_ctl_m1_o.is_jalr_addi_slti_sltiu_xori_ori_andi = 1'b1;
+      uop_ctl_m1_o.is_lui_auipc_jal_jalr_addi_add_sub    = 1'b1;
+      uop_ctl_m1_o.is_alu_reg_imm = 1'b1;
+      uop_ctl_m1_o.is_rvc       = uop_ctl_m1_i.is_rvc;
+    end
+  `endif
+  end
+
+endmodule
@@ -0,0 +1,131 @@
+/*************************************************************/
+//  Module name: N2_idu_rvc
+//  Authority @ lijunnan (lijunnan@nudt.edu.cn)
+//  Last edited time: 2024/06/21
+//  Function outline: expand 16b compressed instr (RV32C) to 32b instr
+//  Note:
+//    1) only RV32C without F/D, illegal/reserved encoding is
+//      expanded to 32'b0 which is trapped by predecode;
+//    2) hints (e.g., c.addi x0, c.li x0) are expanded as normal;
+/*************************************************************/
+import NanoCore_pkg::*;
+
+module N2_idu_rvc (
+  input   wire  [15:0]  instr_c_i,
+  output  logic [31:0]  instr_o
+);
+
+  wire  [15:0]  i = instr_c_i;
+  //* rd'/rs1'/rs2' is x8~x15;
+  wire  [4:0]   rd_c  = {2'b01, i[4:2]};
+  wire  [4:0]   rs1_c = {2'b01, i[9:7]};
+  wire  [4:0]   rd    = i[11:7];
+  wire  [4:0]   rs2   = i[6:2];
+
+  always_comb begin
+    instr_o = 32'b0;
+    case(i[1:0])
+      //* quadrant 0;
+      2'b00: begin
+        case(i[15:13])
+          3'b000: begin //* c.addi4spn -> addi rd', x2, nzuimm
+            if(|i[12:5])
+              instr_o = {2'b0, i[10:7], i[12:11], i[5], i[6], 2'b0, 5'd2, 3'b000, rd_c, 7'b0010011};
+          end
+          3'b010: //* c.lw -> lw rd', offset(rs1')
+            instr_o = {5'b0, i[5], i[12:10], i[6], 2'b0, rs1_c, 3'b010, rd_c, 7'b0000011};
+          3'b110: //* c.sw -> sw rs2', offset(rs1')
+            instr_o = {5'b0, i[5], i[12], rd_c, rs1_c, 3'b010, i[11:10], i[6], 2'b0, 7'b0100011};
+          default: instr_o = 32'b0;
+        endcase
+      end
+      //* quadrant 1;
+      2'b01: begin
+        case(i[15:13])
+          3'b000: //* c.addi/c.nop -> addi rd, rd, imm
+            instr_o = {{7{i[12]}}, i[6:2], rd, 3'b000, rd, 7'b0010011};
+          3'b001, 3'b101: //* c.jal -> jal x1, offset; c.j -> jal x0, offset
+            instr_o = {i[12], i[8], i[10:9], i[6], i[7], i[2], i[11], i[5:3], i[12], {8{i[12]}},
+                        4'b0, ~i[15], 7'b1101111};
+          3'b010: //* c.li -> addi rd, x0, imm
+            instr_o = {{7{i[12]}}, i[6:2], 5'd0, 3'b000, rd, 7'b0010011};
+          3'b011: begin
+            if(rd == 5'd2) begin  //* c.addi16sp -> addi x2, x2, nzimm
+              if(i[12] | (|i[6:2]))
+                instr_o = {{3{i[12]}}, i[4:3], i[5], i[2], i[6], 4'b0, 5'd2, 3'b000, 5'd2, 7'b0010011};
+            end
+            else begin            //* c.lui -> lui rd, nzimm
+              if(i[12] | (|i[6:2]))
+                instr_o = {{15{i[12]}}, i[6:2], rd, 7'b0110111};
+            end
+          end
+          3'b100: begin
+            case(i[11:10])
+              2'b00: begin  //* c.srli -> srli rd', rd', shamt
+                if(~i[12])
+                  instr_o = {7'b0000000, i[6:2], rs1_c, 3'b101, rs1_c, 7'b0010011};
+              end
+              2'b01: begin  //* c.srai -> srai rd', rd', shamt
+                if(~i[12])
+                  instr_o = {7'b0100000, i[6:2], rs1_c, 3'b101, rs1_c, 7'b0010011};
+              end
+              2'b10:        //* c.andi -> andi rd', rd', imm
+                  instr_o = {{7{i[12]}}, i[6:2], rs1_c, 3'b111, rs1_c, 7'b0010011};
+              2'b11: begin  //* c.sub/c.xor/c.or/c.and
+                if(~i[12]) begin
+                  case(i[6:5])
+                    2'b00: instr_o = {7'b0100000, rd_c, rs1_c, 3'b000, rs1_c, 7'b0110011};
+                    2'b01: instr_o = {7'b0000000, rd_c, rs1_c, 3'b100, rs1_c, 7'b0110011};
+                    2'b10: instr_o = {7'b0000000, rd_c, rs1_c, 3'b110, rs1_c, 7'b0110011};
+                    2'b11: instr_o = {7'b0000000, rd_c, rs1_c, 3'b111, rs1_c, 7'b0110011};
+                  endcase
+                end
+              end
+            endcase
+          end
+          3'b110, 3'b111: //* c.beqz -> beq rs1', x0, offset; c.bnez -> bne rs1', x0, offset
+            instr_o = {{4{i[12]}}, i[6:5], i[2], 5'd0, rs1_c, 2'b00, i[13], i[11:10], i[4:3],
+                        i[12], 7'b1100011};
+          default: instr_o = 32'b0;
+        endcase
+      end
+      //* quadrant 2;
+      2'b10: begin
+        case(i[15:13])
+          3'b000: begin //* c.slli -> slli rd, rd, shamt
+            if(~i[12])
+              instr_o = {7'b0000000, i[6:2], rd, 3'b001, rd, 7'b0010011};
+          end
+          3'b010: begin //* c.lwsp -> lw rd, offset(x2)
+            if(rd != 5'd0)
+              instr_o = {4'b0, i[3:2], i[12], i[6:4], 2'b0, 5'd2, 3'b010, rd, 7'b0000011};
+          end
+          3'b100: begin
+            if(~i[12]) begin
+              if(rs2 == 5'd0) begin //* c.jr -> jalr x0, 0(rs1)
+                if(rd != 5'd0)
+                  instr_o = {12'b0, rd, 3'b000, 5'd0, 7'b1100111};
+              end
+              else                  //* c.mv -> add rd, x0, rs2
+                instr_o = {7'b0, rs2, 5'd0, 3'b000, rd, 7'b0110011};
+            end
+            else begin
+              if(rs2 == 5'd0 && rd == 5'd0) //* c.ebreak
+                instr_o = 32'h0010_0073;
+              else if(rs2 == 5'd0)          //* c.jalr -> jalr x1, 0(rs1)
+                instr_o = {12'b0, rd, 3'b000, 5'd1, 7'b1100111};
+              else                          //* c.add -> add rd, rd, rs2
+                instr_o = {7'b0, rs2, rd, 3'b000, rd, 7'b0110011};
+            end
+          end
+          3'b110: //* c.swsp -> sw rs2, offset(x2)
+            instr_o = {4'b0, i[8:7], i[12], rs2, 5'd2, 3'b010, i[11:9], 2'b0, 7'b0100011};
+          default: instr_o = 32'b0;
+        endcase
+      end
+      //* 32b instr, not selected by N2_idu_decode;
+      default: instr_o = 32'b0;
+    endcase
+  end
+
+endmodule
@@ -3,6 +3,23 @@
 //  Authority @ lijunnan (lijunnan@nudt.edu.cn)
 //  Last edited time: 2024/06/21
 //  Function outline: instruction fetch unit
+//  Note:
+//    1) nanoBTB/mBTB give the target, while bht (bimodal/gshare)
+//      gives the direction of conditional branch;
+//    2) ras gives the target of ret, and is repaired by ras_fix_i
+//      when flush;
+//    3) mBTB is NUM_mBTB_WAY-way set-associative (tagged, full 32b
+//      target, lru replacement);
+//    4) instr_prefetch_req_o/addr_o ask icache for the next line;
+//    5) btb entry is indexed by the last halfword of branch (RV32C),
+//      one entry per 32b word, and hit only if the branch ends at
+//      or after the fetch pc of this word;
+//    6) hardware loop (lp.*) jumps back at the last halfword of loop
+//      body like a btb hit, the count is decreased at prefetch and
+//      recovered by ras_fix_i when flush;
+//    7) instr0/1 are two sequential words (not a 64b aligned pair), 
+//      i.e., two instrs are fetched after a jump to an odd word; only 
+//      instr0 is fetched at the last word of a line (32B);
 /*************************************************************/
 import NanoCore_pkg::*;
 
@@ -10,7 +27,9 @@ module N2_ifu #(
   parameter [ 0:0] CATCH_MISALIGN = 1,
   parameter [31:0] PROGADDR_RESET = 32'b0,
   parameter [31:0] PROGADDR_IRQ   = 32'b0,
-  parameter        NUM_nBTB       = 4
+  parameter        NUM_nBTB       = 4,
+  parameter        NUM_mBTB       = 512,  //* total entries of mBTB
+  parameter        NUM_mBTB_WAY   = 2     //* set-associative, <= 2^mbtb_way_bits
 ) (
   input                 clk, resetn, resetn_soc,
 
@@ -32,7 +51,16 @@ module N2_ifu #(
   output  btb_ctl_t     btb_ctl_m0_o,
   output  reg           btb_ctl_m1_v_o,
   output  btb_ctl_t     btb_ctl_m1_o,
-  input   [15:0]        cpuregs_x1,
+  input   ras_fix_t     ras_fix_i,
+  `ifdef ENABLE_HWLOOP
+  input   wire          lp_upd_v_i,
+  input   lp_upd_t      lp_upd_i,
+  input   wire          lp_en_i,
+  `endif
+  `ifdef ENABLE_BHT
+  input   wire          bht_upd_v_ex_i,
+  input   bht_upd_t     bht_upd_ex_i,
+  `endif
 `endif
 
   (* mark_debug = "true"*)output  reg   [ 2:0]  iq_prefetch_ptr,
@@ -41,15 +69,40 @@ module N2_ifu #(
 
   `ifdef ENABLE_BP
     logic [NUM_nBTB-1:0]  nanoBTB_jump_m1, nanoBTB_jump_m0, 
+                          nanoBTB_hit_m1, nanoBTB_hit_m0,
                           nanoBTB_update_d2, nanoBTB_update_ex;
-    logic [15:0]          nanoBTB_tgt_m0, nanoBTB_tgt_m1, 
+    logic [31:0]          nanoBTB_tgt_m0, nanoBTB_tgt_m1, 
                           mBTB_tgt_m0, mBTB_tgt_m1;
     logic                 mBTB_jump_m0, mBTB_jump_m1;
+    logic                 mBTB_hit_m0_b0, mBTB_hit_m0_b1, mBTB_hit_m1;
+    btb_t                 mBTB_rst_m1;  //* bank of instr1, i.e., ~pc[2] of instr0
+    logic [NUM_nBTB-1:0]  nanoBTB_call_m0, nanoBTB_call_m1, 
+                          nanoBTB_ret_m0, nanoBTB_ret_m1;
+    logic                 mBTB_call_m0, mBTB_call_m1, mBTB_ret_m0, mBTB_ret_m1;
+    //* predicted branch ends at the upper halfword of instr0/1;
+    logic                 end_half_m0, end_half_m1;
+    //* the predicted entry (at end_half) is a conditional branch, and it is
+    //*   reached (not skipped by hwloop), i.e., it is counted by ghr;
+    logic                 br_hit_m0, br_hit_m1;
+    logic                 ras_push, ras_pop;
+    logic [31:0]          ras_top, ras_ret_pc;
+    reg   [ras_index_bits-1:0]  ras_ptr;
     btb_t                 btb_rst_m0, btb_rst_m1;
+    //* direction of conditional branch, always '1' without bht;
+    logic                 bht_taken_m0, bht_taken_m1;
+    logic [bht_index_bits-1:0]  bht_idx_m0, bht_idx_m1;
+    //* hardware loop jumps back in instr0/1, always '0 without ENABLE_HWLOOP;
+    logic                 lp_jump_m0, lp_jump_m1, lp_half_m0, lp_half_m1;
+    logic [31:0]          lp_tgt_m0, lp_tgt_m1;
+    logic [1:0][31:0]     lp_cnt_m0, lp_cnt_m1; //* count before instr0/1
   `endif
 
 
   reg   [31:0] reg_next_pc;
+  wire  [31:0] reg_next_pc_w = {reg_next_pc[31:2],2'b0};  //* align to word for add 4/8
+  //* instr1 is the next word of instr0, and is in the same line;
+  wire  [31:0] instr_pc_m1   = {instr_addr_o[31:2] + 30'd1, 2'b0};
+  wire         instr_v_m1    = ~(&instr_addr_o[4:2]);
   wire  [ 2:0] iq_prefetch_ptr_inc1 = iq_prefetch_ptr + 1;
   wire  [ 2:0] iq_prefetch_ptr_inc2 = iq_prefetch_ptr + 2;
   (* mark_debug = "true"*)wire  [ 2:0] iq_usedw = {iq_prefetch_ptr[2]^iq_rd_ptr[2],iq_prefetch_ptr} - {1'b0,iq_rd_ptr};
@@ -57,9 +110,17 @@ module N2_ifu #(
   reg   instr_req;
   assign instr_req_o    = ~flush_i & instr_req;
   assign instr_addr_o   = reg_next_pc;
+  //* next-line prefetch, cache drops it when the line is hit or the port is busy;
+`ifdef ENABLE_IPREFETCH
+  assign instr_prefetch_req_o   = instr_req_o;
+  assign instr_prefetch_addr_o  = {instr_addr_o[31:5] + 27'd1, 5'b0};
+`else
+  assign instr_prefetch_req_o   = 1'b0;
+  assign instr_prefetch_addr_o  = '0;
+`endif
   //* instr_req_2b_o is later than instr_req_o, has not been used in combinational logic
   assign instr_req_2b_o = {2{instr_req_o}} &
-                          {~(instr_addr_o[2] | (|nanoBTB_jump_m0) | (mBTB_jump_m0)),1'b1};
+                          {instr_v_m1 & ~((|nanoBTB_jump_m0) | (mBTB_jump_m0) | lp_jump_m0),1'b1};
 
   always_ff @(posedge clk) begin
     reg_next_pc         <= reg_next_pc;
@@ -84,22 +145,45 @@ module N2_ifu #(
       reg_next_pc       <= flush_i? branch_pc_i:
                           (stall_prefetch | ~instr_gnt_i)? reg_next_pc: 
       `ifdef ENABLE_BP
+                            lp_jump_m0? lp_tgt_m0:
                             |nanoBTB_jump_m0? nanoBTB_tgt_m0:
                             |mBTB_jump_m0? mBTB_tgt_m0:
+                            lp_jump_m1? lp_tgt_m1:
                             |nanoBTB_jump_m1? nanoBTB_tgt_m1:
                             |mBTB_jump_m1? mBTB_tgt_m1:
       `endif
-                            reg_next_pc[2]? (reg_next_pc + 32'd4):
-                            (reg_next_pc + 32'd8);
+                            (&reg_next_pc[4:2])? (reg_next_pc_w + 32'd4):
+                            (reg_next_pc_w + 32'd8);
       `ifdef ENABLE_BP
-        btb_ctl_m0_o.jump    <= ~instr_gnt_i? btb_ctl_m0_o.jump:|{nanoBTB_jump_m0,mBTB_jump_m0};
-        btb_ctl_m0_o.tgt     <= ~instr_gnt_i? btb_ctl_m0_o.tgt: 
+        btb_ctl_m0_o.jump    <= ~instr_gnt_i? btb_ctl_m0_o.jump:|{nanoBTB_jump_m0,mBTB_jump_m0,lp_jump_m0};
+        btb_ctl_m0_o.hit     <= ~instr_gnt_i? btb_ctl_m0_o.hit: |{nanoBTB_hit_m0,mBTB_hit_m0_b0,mBTB_hit_m0_b1};
+        btb_ctl_m0_o.jmp_half<= ~instr_gnt_i? btb_ctl_m0_o.jmp_half: lp_jump_m0? lp_half_m0: end_half_m0;
+        btb_ctl_m0_o.tgt     <= ~instr_gnt_i? btb_ctl_m0_o.tgt: lp_jump_m0? lp_tgt_m0:
                                 |nanoBTB_jump_m0? nanoBTB_tgt_m0: mBTB_tgt_m0;
-        btb_ctl_m0_o.pc      <= ~instr_gnt_i? btb_ctl_m0_o.pc:  instr_addr_o[15:0];
-        btb_ctl_m1_o.jump    <= ~instr_gnt_i? btb_ctl_m1_o.jump:|{nanoBTB_jump_m1,mBTB_jump_m1};
-        btb_ctl_m1_o.tgt     <= ~instr_gnt_i? btb_ctl_m1_o.tgt: 
+        btb_ctl_m0_o.pc      <= ~instr_gnt_i? btb_ctl_m0_o.pc:  instr_addr_o;
+        btb_ctl_m0_o.bht_idx <= ~instr_gnt_i? btb_ctl_m0_o.bht_idx: bht_idx_m0;
+        btb_ctl_m0_o.ras_ptr <= ~instr_gnt_i? btb_ctl_m0_o.ras_ptr: ras_ptr;
+        btb_ctl_m0_o.hit_mbtb<= ~instr_gnt_i? btb_ctl_m0_o.hit_mbtb: mBTB_hit_m0_b0 | mBTB_hit_m0_b1;
+        btb_ctl_m0_o.way_mbtb<= ~instr_gnt_i? btb_ctl_m0_o.way_mbtb: 
+                                mBTB_hit_m0_b0? btb_rst_m0.way_mbtb: btb_rst_m1.way_mbtb;
+        btb_ctl_m0_o.ras_top <= ~instr_gnt_i? btb_ctl_m0_o.ras_top: ras_top;
+        btb_ctl_m0_o.lp_cnt  <= ~instr_gnt_i? btb_ctl_m0_o.lp_cnt: lp_cnt_m0;
+        btb_ctl_m0_o.br_hit  <= ~instr_gnt_i? btb_ctl_m0_o.br_hit: br_hit_m0;
+        btb_ctl_m0_o.br_half <= ~instr_gnt_i? btb_ctl_m0_o.br_half: end_half_m0;
+        btb_ctl_m1_o.jump    <= ~instr_gnt_i? btb_ctl_m1_o.jump:|{nanoBTB_jump_m1,mBTB_jump_m1,lp_jump_m1};
+        btb_ctl_m1_o.hit     <= ~instr_gnt_i? btb_ctl_m1_o.hit: |{nanoBTB_hit_m1,mBTB_hit_m1};
+        btb_ctl_m1_o.jmp_half<= ~instr_gnt_i? btb_ctl_m1_o.jmp_half: lp_jump_m1? lp_half_m1: end_half_m1;
+        btb_ctl_m1_o.tgt     <= ~instr_gnt_i? btb_ctl_m1_o.tgt: lp_jump_m1? lp_tgt_m1:
                                 |nanoBTB_jump_m1? nanoBTB_tgt_m1: mBTB_tgt_m1;
-        btb_ctl_m1_o.pc      <= ~instr_gnt_i? btb_ctl_m1_o.pc:  {instr_addr_o[15:3],3'b100};
+        btb_ctl_m1_o.pc      <= ~instr_gnt_i? btb_ctl_m1_o.pc:  instr_pc_m1;
+        btb_ctl_m1_o.bht_idx <= ~instr_gnt_i? btb_ctl_m1_o.bht_idx: bht_idx_m1;
+        btb_ctl_m1_o.ras_ptr <= ~instr_gnt_i? btb_ctl_m1_o.ras_ptr: ras_ptr;
+        btb_ctl_m1_o.hit_mbtb<= ~instr_gnt_i? btb_ctl_m1_o.hit_mbtb: mBTB_hit_m1;
+        btb_ctl_m1_o.way_mbtb<= ~instr_gnt_i? btb_ctl_m1_o.way_mbtb: mBTB_rst_m1.way_mbtb;
+        btb_ctl_m1_o.ras_top <= ~instr_gnt_i? btb_ctl_m1_o.ras_top: ras_top;
+        btb_ctl_m1_o.lp_cnt  <= ~instr_gnt_i? btb_ctl_m1_o.lp_cnt: lp_cnt_m1;
+        btb_ctl_m1_o.br_hit  <= ~instr_gnt_i? btb_ctl_m1_o.br_hit: br_hit_m1;
+        btb_ctl_m1_o.br_half <= ~instr_gnt_i? btb_ctl_m1_o.br_half: end_half_m1;
       `endif
       // //* jalr/bru;
       // if(flush_i) begin
@@ -119,7 +203,11 @@ module N2_ifu #(
       //   `endif
       // end
     end
+  `ifdef ENABLE_RVC
+    reg_next_pc[0]      <= 1'b0;
+  `else
     reg_next_pc[1:0]    <= '0;
+  `endif
   end
 
   `ifdef ENABLE_BP
@@ -169,51 +257,230 @@ module N2_ifu #(
     //* lookup NanoBTB;
     always_comb begin
       for(integer i=0; i<NUM_nBTB; i=i+1) begin
-        nanoBTB_jump_m1[i]  =  btb_entry[i].valid & ~instr_addr_o[2] &
-                                (btb_entry[i].pc[15:2] == {instr_addr_o[15:3],1'b1});
-        nanoBTB_jump_m0[i]  =  btb_entry[i].valid &
-                                (btb_entry[i].pc[15:2] == instr_addr_o[15:2]);
+        nanoBTB_hit_m1[i]   =  btb_entry[i].valid & instr_v_m1 &
+                                (btb_entry[i].pc[31:2] == instr_pc_m1[31:2]);
+        nanoBTB_hit_m0[i]   =  btb_entry[i].valid &
+                                (btb_entry[i].pc[31:2] == instr_addr_o[31:2]) &
+                                (btb_entry[i].pc[1] | ~instr_addr_o[1]);
+        nanoBTB_jump_m1[i]  =  nanoBTB_hit_m1[i] & (~btb_entry[i].is_br | bht_taken_m1);
+        nanoBTB_jump_m0[i]  =  nanoBTB_hit_m0[i] & (~btb_entry[i].is_br | bht_taken_m0);
+        nanoBTB_call_m1[i]  =  nanoBTB_hit_m1[i] & btb_entry[i].is_call;
+        nanoBTB_call_m0[i]  =  nanoBTB_hit_m0[i] & btb_entry[i].is_call;
+        nanoBTB_ret_m1[i]   =  nanoBTB_hit_m1[i] & btb_entry[i].is_ret;
+        nanoBTB_ret_m0[i]   =  nanoBTB_hit_m0[i] & btb_entry[i].is_ret;
       end
     end
     always_comb begin
       nanoBTB_tgt_m0    = '0;
       nanoBTB_tgt_m1    = '0;
       for(integer i=0; i<NUM_nBTB; i=i+1) begin
-        nanoBTB_tgt_m0  = nanoBTB_tgt_m0 | {16{nanoBTB_jump_m0[i]}} & btb_entry[i].tgt;
-        nanoBTB_tgt_m1  = nanoBTB_tgt_m1 | {16{nanoBTB_jump_m1[i]}} & btb_entry[i].tgt;
+        nanoBTB_tgt_m0  = nanoBTB_tgt_m0 | {32{nanoBTB_jump_m0[i]}} & 
+                            (btb_entry[i].is_ret? ras_top: btb_entry[i].tgt);
+        nanoBTB_tgt_m1  = nanoBTB_tgt_m1 | {32{nanoBTB_jump_m1[i]}} & 
+                            (btb_entry[i].is_ret? ras_top: btb_entry[i].tgt);
       end
     end
     always_comb begin
       for(integer i=0; i<NUM_nBTB; i=i+1) begin
-        nanoBTB_update_ex[i] = (btb_entry[i].pc == btb_upd_ex_i.pc);
-        nanoBTB_update_d2[i] = (btb_entry[i].pc == btb_upd_d2_i.pc);
+        nanoBTB_update_ex[i] = (btb_entry[i].pc[31:2] == btb_upd_ex_i.pc[31:2]);
+        nanoBTB_update_d2[i] = (btb_entry[i].pc[31:2] == btb_upd_d2_i.pc[31:2]);
       end
     end
 
     //* lookup btb
     always_comb begin
-      mBTB_jump_m0 = (btb_rst_m0.pc == instr_addr_o[15:0]) & btb_rst_m0.valid |
-                     (btb_rst_m1.pc == instr_addr_o[15:0]) & btb_rst_m1.valid;
-      mBTB_jump_m1 = (btb_rst_m1.pc == {instr_addr_o[15:3],3'b100}) & btb_rst_m1.valid;
-      mBTB_tgt_m0  = ((btb_rst_m0.pc == instr_addr_o[15:0]) & btb_rst_m0.valid)? 
-                       ({16{~btb_rst_m0.is_jarl}} & btb_rst_m0.tgt | 
-                        {16{ btb_rst_m0.is_jarl}} & cpuregs_x1): 
-                       ({16{~btb_rst_m1.is_jarl}} & btb_rst_m1.tgt | 
-                        {16{ btb_rst_m1.is_jarl}} & cpuregs_x1);
-      mBTB_tgt_m1  = ({16{~btb_rst_m1.is_jarl}} & btb_rst_m1.tgt | 
-                      {16{ btb_rst_m1.is_jarl}} & cpuregs_x1);
+      mBTB_hit_m0_b0 = (btb_rst_m0.pc[31:2] == instr_addr_o[31:2]) & btb_rst_m0.valid &
+                       (btb_rst_m0.pc[1] | ~instr_addr_o[1]);
+      mBTB_hit_m0_b1 = (btb_rst_m1.pc[31:2] == instr_addr_o[31:2]) & btb_rst_m1.valid &
+                       (btb_rst_m1.pc[1] | ~instr_addr_o[1]);
+      mBTB_rst_m1    = instr_addr_o[2]? btb_rst_m0: btb_rst_m1;
+      mBTB_hit_m1    = (mBTB_rst_m1.pc[31:2] == instr_pc_m1[31:2]) & mBTB_rst_m1.valid & instr_v_m1;
+      mBTB_jump_m0 = mBTB_hit_m0_b0 & (~btb_rst_m0.is_br | bht_taken_m0) |
+                     mBTB_hit_m0_b1 & (~btb_rst_m1.is_br | bht_taken_m0);
+      mBTB_jump_m1 = mBTB_hit_m1 & (~mBTB_rst_m1.is_br | bht_taken_m1);
+      mBTB_tgt_m0  = mBTB_hit_m0_b0? 
+                       ({32{~btb_rst_m0.is_ret}} & btb_rst_m0.tgt | 
+                        {32{ btb_rst_m0.is_ret}} & ras_top): 
+                       ({32{~btb_rst_m1.is_ret}} & btb_rst_m1.tgt | 
+                        {32{ btb_rst_m1.is_ret}} & ras_top);
+      mBTB_tgt_m1  = ({32{~mBTB_rst_m1.is_ret}} & mBTB_rst_m1.tgt | 
+                      {32{ mBTB_rst_m1.is_ret}} & ras_top);
+      mBTB_call_m0 = mBTB_hit_m0_b0? btb_rst_m0.is_call: mBTB_hit_m0_b1 & btb_rst_m1.is_call;
+      mBTB_ret_m0  = mBTB_hit_m0_b0? btb_rst_m0.is_ret:  mBTB_hit_m0_b1 & btb_rst_m1.is_ret;
+      mBTB_call_m1 = mBTB_hit_m1 & mBTB_rst_m1.is_call;
+      mBTB_ret_m1  = mBTB_hit_m1 & mBTB_rst_m1.is_ret;
+    end
+    always_comb begin
+      end_half_m0   = mBTB_hit_m0_b0? btb_rst_m0.pc[1]: btb_rst_m1.pc[1];
+      end_half_m1   = mBTB_rst_m1.pc[1];
+      if(|nanoBTB_hit_m0) begin
+        end_half_m0 = 1'b0;
+        for(integer i=0; i<NUM_nBTB; i=i+1)
+          end_half_m0 = end_half_m0 | nanoBTB_hit_m0[i] & btb_entry[i].pc[1];
+      end
+      if(|nanoBTB_hit_m1) begin
+        end_half_m1 = 1'b0;
+        for(integer i=0; i<NUM_nBTB; i=i+1)
+          end_half_m1 = end_half_m1 | nanoBTB_hit_m1[i] & btb_entry[i].pc[1];
+      end
     end
+    always_comb begin
+      br_hit_m0     = mBTB_hit_m0_b0? btb_rst_m0.is_br: mBTB_hit_m0_b1 & btb_rst_m1.is_br;
+      br_hit_m1     = mBTB_hit_m1 & mBTB_rst_m1.is_br;
+      if(|nanoBTB_hit_m0) begin
+        br_hit_m0   = 1'b0;
+        for(integer i=0; i<NUM_nBTB; i=i+1)
+          br_hit_m0 = br_hit_m0 | nanoBTB_hit_m0[i] & btb_entry[i].is_br;
+      end
+      if(|nanoBTB_hit_m1) begin
+        br_hit_m1   = 1'b0;
+        for(integer i=0; i<NUM_nBTB; i=i+1)
+          br_hit_m1 = br_hit_m1 | nanoBTB_hit_m1[i] & btb_entry[i].is_br;
+      end
+      //* skipped by a hwloop jump at the lower halfword;
+      br_hit_m0     = br_hit_m0 & ~(lp_jump_m0 & ~lp_half_m0 & end_half_m0);
+      br_hit_m1     = br_hit_m1 & ~(lp_jump_m1 & ~lp_half_m1 & end_half_m1);
+    end
+
+    //* return address stack, push by call & pop by ret at prefetch (nanoBTB 
+    //*   first, the same as target), instr1 is fetched only when instr0 is 
+    //*   not jump, and call/ret is always jump (so call/ret after the end 
+    //*   of hardware loop is skipped by lp_jump);
+    always_comb begin
+      ras_push    = 1'b0;
+      ras_pop     = 1'b0;
+      ras_ret_pc  = {instr_addr_o[31:2],end_half_m0,1'b0} + 32'd2;
+      if(~lp_jump_m0 & (|nanoBTB_hit_m0 | mBTB_hit_m0_b0 | mBTB_hit_m0_b1)) begin
+        ras_push  = |nanoBTB_hit_m0? |nanoBTB_call_m0: mBTB_call_m0;
+        ras_pop   = |nanoBTB_hit_m0? |nanoBTB_ret_m0:  mBTB_ret_m0;
+      end
+      if(~(|nanoBTB_jump_m0 | mBTB_jump_m0 | lp_jump_m0 | lp_jump_m1) & 
+          (|nanoBTB_hit_m1 | mBTB_hit_m1)) begin
+        ras_push  = |nanoBTB_hit_m1? |nanoBTB_call_m1: mBTB_call_m1;
+        ras_pop   = |nanoBTB_hit_m1? |nanoBTB_ret_m1:  mBTB_ret_m1;
+        ras_ret_pc= {instr_pc_m1[31:2],end_half_m1,1'b0} + 32'd2;
+      end
+    end
+
+    reg   [31:0]  ras_entry[(1<<ras_index_bits)-1:0];
+    wire  [ras_index_bits-1:0]  ras_ptr_fix = ras_fix_i.ras_ptr - ras_fix_i.pop;
+    wire  [ras_index_bits-1:0]  ras_ptr_fix_inc = ras_ptr_fix + 1;
+    wire  [ras_index_bits-1:0]  ras_ptr_inc = ras_ptr + 1;
+    wire  [ras_index_bits-1:0]  ras_ptr_dec = ras_ptr - 1;
+    assign ras_top = ras_entry[ras_ptr];
+    always_ff @(posedge clk or negedge resetn) begin
+      if(!resetn) begin
+        ras_ptr                 <= '0;
+      end
+      else if(flush_i) begin
+        //* recover checkpoint, then redo call/ret which causes flush;
+        ras_entry[ras_fix_i.ras_ptr]  <= ras_fix_i.ras_top;
+        ras_ptr                 <= ras_fix_i.push? ras_ptr_fix_inc: ras_ptr_fix;
+        if(ras_fix_i.push)
+          ras_entry[ras_ptr_fix_inc]  <= ras_fix_i.ret_pc;
+      end
+      else if(~stall_prefetch & instr_gnt_i) begin
+        //* pop then push, i.e., replace the top;
+        if(ras_push & ras_pop) begin
+          ras_entry[ras_ptr]    <= ras_ret_pc;
+        end
+        else if(ras_push) begin
+          ras_ptr               <= ras_ptr_inc;
+          ras_entry[ras_ptr_inc]<= ras_ret_pc;
+        end
+        else if(ras_pop) begin
+          ras_ptr               <= ras_ptr_dec;
+        end
+      end
+    end
+
+    `ifdef ENABLE_HWLOOP
+      //* level 0 is the inner loop, a loop is active while count != 0; in a word,
+      //*   loop end after a predicted jump (btb) is not reached, and the lower 
+      //*   halfword (or level 0 at the same halfword) goes first;
+      reg   [1:0][31:0] lp_start, lp_last, lp_cnt;
+      logic [1:0][31:0] lp_cnt_nxt;
+      logic [1:0]       lp_hit_m0, lp_hit_m1, lp_sel_m0, lp_sel_m1, lp_dec_m0, lp_dec_m1;
+      always_comb begin
+        lp_cnt_m0         = lp_cnt;
+        for(integer k=0; k<2; k=k+1)
+          lp_hit_m0[k]    = lp_en_i & (|lp_cnt_m0[k]) & 
+                            (lp_last[k][31:2] == instr_addr_o[31:2]) &
+                            (lp_last[k][1] | ~instr_addr_o[1]) &
+                            ~((|nanoBTB_jump_m0 | mBTB_jump_m0) & ~end_half_m0 & lp_last[k][1]);
+        lp_sel_m0[0]      = lp_hit_m0[0] & (lp_cnt_m0[0] > 1) &
+                            ~(lp_hit_m0[1] & (lp_cnt_m0[1] > 1) & ~lp_last[1][1] & lp_last[0][1]);
+        lp_sel_m0[1]      = lp_hit_m0[1] & (lp_cnt_m0[1] > 1) & ~lp_sel_m0[0];
+        lp_jump_m0        = |lp_sel_m0;
+        lp_half_m0        = lp_sel_m0[0]? lp_last[0][1]: lp_last[1][1];
+        lp_tgt_m0         = lp_sel_m0[0]? lp_start[0]:   lp_start[1];
+        lp_dec_m0[0]      = lp_hit_m0[0] & (lp_sel_m0[0] | ~lp_sel_m0[1] | ~lp_last[0][1] | lp_last[1][1]);
+        lp_dec_m0[1]      = lp_hit_m0[1] & (lp_sel_m0[1] | ~lp_sel_m0[0] | ~lp_last[1][1] & lp_last[0][1]);
+
+        //* instr1 is fetched only when instr0 is not jump;
+        for(integer k=0; k<2; k=k+1) begin
+          lp_cnt_m1[k]    = lp_cnt_m0[k] - lp_dec_m0[k];
+          lp_hit_m1[k]    = lp_en_i & (|lp_cnt_m1[k]) & instr_v_m1 &
+                            ~(|nanoBTB_jump_m0 | mBTB_jump_m0 | lp_jump_m0) &
+                            (lp_last[k][31:2] == instr_pc_m1[31:2]) &
+                            ~((|nanoBTB_jump_m1 | mBTB_jump_m1) & ~end_half_m1 & lp_last[k][1]);
+        end
+        lp_sel_m1[0]      = lp_hit_m1[0] & (lp_cnt_m1[0] > 1) &
+                            ~(lp_hit_m1[1] & (lp_cnt_m1[1] > 1) & ~lp_last[1][1] & lp_last[0][1]);
+        lp_sel_m1[1]      = lp_hit_m1[1] & (lp_cnt_m1[1] > 1) & ~lp_sel_m1[0];
+        lp_jump_m1        = |lp_sel_m1;
+        lp_half_m1        = lp_sel_m1[0]? lp_last[0][1]: lp_last[1][1];
+        lp_tgt_m1         = lp_sel_m1[0]? lp_start[0]:   lp_start[1];
+        lp_dec_m1[0]      = lp_hit_m1[0] & (lp_sel_m1[0] | ~lp_sel_m1[1] | ~lp_last[0][1] | lp_last[1][1]);
+        lp_dec_m1[1]      = lp_hit_m1[1] & (lp_sel_m1[1] | ~lp_sel_m1[0] | ~lp_last[1][1] & lp_last[0][1]);
+        for(integer k=0; k<2; k=k+1)
+          lp_cnt_nxt[k]   = lp_cnt_m1[k] - lp_dec_m1[k];
+      end
+
+      //* start/end are written by lp.* (not from wrong path, as it is older 
+      //*   than any instr in exec), count is written with ras;
+      always_ff @(posedge clk or negedge resetn) begin
+        if(!resetn) begin
+          lp_cnt                  <= '0;
+        end
+        else begin
+          if(flush_i)
+            lp_cnt                <= ras_fix_i.lp_cnt;
+          else if(~stall_prefetch & instr_gnt_i)
+            lp_cnt                <= lp_cnt_nxt;
+          if(lp_upd_v_i & lp_upd_i.set_start)
+            lp_start[lp_upd_i.level]  <= lp_upd_i.start;
+          if(lp_upd_v_i & lp_upd_i.set_end)
+            lp_last[lp_upd_i.level]   <= lp_upd_i.last;
+        end
+      end
+    `else
+      assign lp_jump_m0 = 1'b0;
+      assign lp_jump_m1 = 1'b0;
+      assign lp_half_m0 = 1'b0;
+      assign lp_half_m1 = 1'b0;
+      assign lp_tgt_m0  = '0;
+      assign lp_tgt_m1  = '0;
+      assign lp_cnt_m0  = '0;
+      assign lp_cnt_m1  = '0;
+    `endif
     
-    reg  [15:0] r_lookup_pc;
-    wire [15:0] lookup_pc = flush_i? {branch_pc_i[15:3],3'b0}:
-                            (~stall_prefetch & instr_gnt_i)? ({instr_addr_o[15:3],3'b0} + 8):
+    //* pc of the next sequential fetch (word), the same as reg_next_pc without jump;
+    reg  [31:0] r_lookup_pc;
+    wire [31:0] lookup_pc = flush_i? {branch_pc_i[31:2],2'b0}:
+                            (~stall_prefetch & instr_gnt_i)? 
+                              ((&instr_addr_o[4:2])? {instr_addr_o[31:3],3'b0} + 8: 
+                                                     {instr_addr_o[31:2],2'b0} + 8):
                               r_lookup_pc;
     always_ff @(posedge clk or posedge resetn) begin
       r_lookup_pc     <= lookup_pc;
       if(!resetn)
         r_lookup_pc   <= PROGADDR_RESET;
     end
-    N2_ifu_btb N2_ifu_btb(
+    N2_ifu_btb #(
+      .NUM_mBTB       (NUM_mBTB       ),
+      .NUM_WAY        (NUM_mBTB_WAY   )
+    ) N2_ifu_btb(
       .clk            (clk            ),
       .resetn_soc     (resetn_soc     ),
       .resetn         (resetn         ),
@@ -227,17 +494,119 @@ module N2_ifu #(
       .btb_upd_d2_i   (btb_upd_d2_i   )
     );
 
+    `ifdef ENABLE_BHT
+      logic [bht_index_bits-1:0]  ghr_m0, ghr_m1;
+      `ifdef BHT_GSHARE
+        //* ghr_spec is shifted at prefetch by the predicted direction, and is
+        //*   recovered by ghr_commit (shifted by exec) when flush; both count
+        //*   the same branches, i.e., br_hit (carried by btb_ctl to exec);
+        reg   [bht_index_bits-1:0]  ghr_spec, ghr_commit;
+        wire  [bht_index_bits-1:0]  ghr_commit_nxt = (bht_upd_v_ex_i & bht_upd_ex_i.ghr_shift)? 
+                                      {ghr_commit[bht_index_bits-2:0],bht_upd_ex_i.inc_bht}: ghr_commit;
+        logic jump_m0;
+        always_comb begin
+          jump_m0 = |nanoBTB_jump_m0 | mBTB_jump_m0 | lp_jump_m0;
+          //* instr1 is fetched only when instr0 is not taken;
+          ghr_m0  = ghr_spec;
+          ghr_m1  = br_hit_m0? {ghr_spec[bht_index_bits-2:0],1'b0}: ghr_spec;
+        end
+        always_ff @(posedge clk or negedge resetn) begin
+          if(!resetn) begin
+            ghr_spec        <= '0;
+            ghr_commit      <= '0;
+          end
+          else begin
+            ghr_commit      <= ghr_commit_nxt;
+            if(flush_i)
+              ghr_spec      <= ghr_commit_nxt;
+            else if(~stall_prefetch & instr_gnt_i) begin
+              //* instr0's branch is not taken if instr1 is fetched;
+              if(br_hit_m0 & br_hit_m1 & ~jump_m0)
+                ghr_spec    <= {ghr_spec[bht_index_bits-3:0],1'b0,bht_taken_m1};
+              else if(br_hit_m0)
+                ghr_spec    <= {ghr_spec[bht_index_bits-2:0],bht_taken_m0};
+              else if(br_hit_m1 & ~jump_m0)
+                ghr_spec    <= {ghr_spec[bht_index_bits-2:0],bht_taken_m1};
+            end
+          end
+        end
+      `else
+        //* bimodal, indexed by pc only;
+        assign ghr_m0 = '0;
+        assign ghr_m1 = '0;
+      `endif
+
+      N2_ifu_bht N2_ifu_bht(
+        .clk            (clk            ),
+        .resetn         (resetn         ),
+        .lookup_pc_i    (instr_addr_o[15:0]),
+        .lookup_pc_m1_i (instr_pc_m1[15:0]),
+        .ghr_m0_i       (ghr_m0         ),
+        .ghr_m1_i       (ghr_m1         ),
+        .bht_idx_m0_o   (bht_idx_m0     ),
+        .bht_idx_m1_o   (bht_idx_m1     ),
+        .bht_taken_m0_o (bht_taken_m0   ),
+        .bht_taken_m1_o (bht_taken_m1   ),
+        .bht_upd_v_i    (bht_upd_v_ex_i ),
+        .bht_upd_i      (bht_upd_ex_i   )
+      );
+    `else
+      assign bht_taken_m0 = 1'b1;
+      assign bht_taken_m1 = 1'b1;
+      assign bht_idx_m0   = '0;
+      assign bht_idx_m1   = '0;
+    `endif
+
   `endif
 
 endmodule
 
+//* 2-bit saturating counters, indexed by pc^ghr (ghr is '0 for bimodal);
+module N2_ifu_bht (
+  input                 clk, resetn,
+
+  input   wire  [15:0]  lookup_pc_i,
+  input   wire  [15:0]  lookup_pc_m1_i,
+  input   wire  [bht_index_bits-1:0]  ghr_m0_i, ghr_m1_i,
+  output  wire  [bht_index_bits-1:0]  bht_idx_m0_o, bht_idx_m1_o,
+  output  wire          bht_taken_m0_o, bht_taken_m1_o,
+
+  input   wire          bht_upd_v_i,
+  input   bht_upd_t     bht_upd_i
+);
+  localparam NUM_BHT = 1 << bht_index_bits;
+
+  reg   [1:0]   bht_cnt[NUM_BHT-1:0];
+  wire  [1:0]   bht_cnt_upd = bht_cnt[bht_upd_i.bht_idx];
+
+  assign bht_idx_m0_o   = lookup_pc_i[2+:bht_index_bits] ^ ghr_m0_i;
+  assign bht_idx_m1_o   = lookup_pc_m1_i[2+:bht_index_bits] ^ ghr_m1_i;
+  assign bht_taken_m0_o = bht_cnt[bht_idx_m0_o][1];
+  assign bht_taken_m1_o = bht_cnt[bht_idx_m1_o][1];
+
+  always_ff @(posedge clk or negedge resetn) begin
+    if(!resetn) begin
+      //* weakly taken, as btb entry is only inserted by taken branch;
+      for(integer i=0; i<NUM_BHT; i=i+1)
+        bht_cnt[i]    <= 2'b10;
+    end
+    else if(bht_upd_v_i) begin
+      if(bht_upd_i.inc_bht & (bht_cnt_upd != 2'b11))
+        bht_cnt[bht_upd_i.bht_idx]  <= bht_cnt_upd + 2'd1;
+      else if(~bht_upd_i.inc_bht & (bht_cnt_upd != 2'b00))
+        bht_cnt[bht_upd_i.bht_idx]  <= bht_cnt_upd - 2'd1;
+    end
+  end
+
+endmodule
+
 module N2_ifu_btb #(
-  parameter             NUM_mBTB = 512
+  parameter             NUM_mBTB = 512,
+  parameter             NUM_WAY  = 2
 ) (
   input                 clk, resetn_soc, resetn,
 
-  input                 flush_i,
-  input   wire  [15:0]  lookup_pc_i,
+  input   wire  [31:0]  lookup_pc_i,
   output  btb_t         btb_rst_m0_o,
   output  btb_t         btb_rst_m1_o,
 
@@ -246,88 +615,41 @@ module N2_ifu_btb #(
   input   wire          btb_upd_v_d2_i,
   input   btb_t         btb_upd_d2_i
 );
-  localparam DEPTH_mBTB = $clog2(NUM_mBTB);
-
-// btb_t  mbtb_entry[NUM_mBTB-1:0];
-wire   [15:0] lookup_pc_m1 = {lookup_pc_i[15:3],3'b100};
-
-// always_ff @(posedge clk or negedge resetn) begin
-//   btb_rst_m0_o  <=  mbtb_entry[lookup_pc_i[2+:DEPTH_mBTB]];
-//   btb_rst_m1_o  <=  mbtb_entry[lookup_pc_m1[2+:DEPTH_mBTB]];
-//   if(btb_upd_v_ex_i)
-//     for(integer i=0; i<NUM_mBTB; i=i+1) begin
-//       if(i == btb_upd_ex_i.pc[2+:DEPTH_mBTB]) begin
-//           mbtb_entry[i] <= btb_upd_ex_i;
-//       end
-//     end
-//   if(btb_upd_v_d2_i)
-//     for(integer i=0; i<NUM_mBTB; i=i+1) begin
-//       if(i == btb_upd_d2_i.pc[2+:DEPTH_mBTB]) begin
-//           mbtb_entry[i] <= btb_upd_d2_i;
-//       end
-//     end
-//   if(!resetn) begin
-//     for(integer i=0; i<NUM_mBTB; i=i+1)
-//       mbtb_entry[i].valid <= 0;
-//   end
-// end
-
-  reg           wren_bank0, wren_bank1;
-  reg   [33:0]  wdata_bank0, wdata_bank1;
-  reg   [ 8:0]  addr_bank0, addr_bank1;
-  reg           resetn_delay;
+  //* two banks (even/odd word, selected by pc[2]), each bank is a 
+  //*   NUM_WAY-way set-associative table, and each way is a sram;
+  //* lookup_pc_i is the pc of instr0, bank 0 reads the next pair if it is 
+  //*   odd, i.e., the bank of instr1;
+  //* entry is {valid, is_br, is_call, is_ret, tag, end_half, tgt};
+  localparam NUM_SET  = NUM_mBTB/2/NUM_WAY;
+  localparam SET_BITS = $clog2(NUM_SET);
+  localparam TAG_BITS = 32 - 3 - SET_BITS;
+  localparam WAY_BITS = (NUM_WAY > 1)? $clog2(NUM_WAY): 1;
+  localparam ENTRY_W  = 5 + TAG_BITS + 32;
+
   reg           state_btb;
+  reg           resetn_delay;
+  reg   [SET_BITS-1:0]  init_addr;
   localparam    IDLE_S  = 0,
                 READY_S = 1;
 
-
+  //* init all entries (valid = 0) after reset;
   always_ff @(posedge clk or negedge resetn_soc) begin
     if(!resetn_soc) begin
-      wren_bank0          <= 1'b0;
-      wren_bank1          <= 1'b0;
-      addr_bank1          <= '0;
-      addr_bank0          <= '0;
+      init_addr           <= '0;
       state_btb           <= IDLE_S;
     end
     else begin
-      wren_bank0          <= btb_upd_v_ex_i & ~btb_upd_ex_i.pc[2] |
-                              btb_upd_v_d2_i & ~btb_upd_d2_i.pc[2];
-      wren_bank1          <= btb_upd_v_ex_i & btb_upd_ex_i.pc[2] |
-                              btb_upd_v_d2_i & btb_upd_d2_i.pc[2];
-      wdata_bank0         <= btb_upd_v_ex_i & ~btb_upd_ex_i.pc[2]? 
-                             {btb_upd_ex_i.valid, btb_upd_ex_i.is_jarl, 
-                              btb_upd_ex_i.pc, btb_upd_ex_i.tgt}: 
-                             {btb_upd_d2_i.valid, btb_upd_d2_i.is_jarl, 
-                              btb_upd_d2_i.pc, btb_upd_d2_i.tgt}; 
-      wdata_bank1         <= btb_upd_v_ex_i & btb_upd_ex_i.pc[2]? 
-                             {btb_upd_ex_i.valid, btb_upd_ex_i.is_jarl, 
-                              btb_upd_ex_i.pc, btb_upd_ex_i.tgt}: 
-                             {btb_upd_d2_i.valid, btb_upd_d2_i.is_jarl, 
-                              btb_upd_d2_i.pc, btb_upd_d2_i.tgt}; 
-      addr_bank0          <= btb_upd_v_ex_i & ~btb_upd_ex_i.pc[2]? 
-                             btb_upd_ex_i.pc[3+:9]: btb_upd_d2_i.pc[3+:9];
-      addr_bank1          <= btb_upd_v_ex_i & btb_upd_ex_i.pc[2]? 
-                             btb_upd_ex_i.pc[3+:9]: btb_upd_d2_i.pc[3+:9];
       resetn_delay        <= resetn;
       case(state_btb)
         IDLE_S: begin
-          addr_bank0      <= addr_bank1 + 1;
-          addr_bank1      <= addr_bank1 + 1;
-          wren_bank0      <= 1;
-          wren_bank1      <= 1;
-          wdata_bank0     <= '0;
-          wdata_bank1     <= '0;
-          if(addr_bank0 == 9'h1ff) begin
+          init_addr       <= init_addr + 1;
+          if(&init_addr)
             state_btb     <= READY_S;
-          end
         end
         READY_S: begin
           if(~resetn & resetn_delay) begin
             state_btb     <= IDLE_S;
-            wren_bank0    <= 1'b0;
-            wren_bank1    <= 1'b0;
-            addr_bank1    <= '0;
-            addr_bank0    <= '0;
+            init_addr     <= '0;
           end
         end
         default: begin end
@@ -335,79 +657,142 @@ wire   [15:0] lookup_pc_m1 = {lookup_pc_i[15:3],3'b100};
     end
   end
 
-  `ifdef XILINX_FIFO_RAM
-    ram_34_512 btb_bank0(
-      .clka   (clk                    ),
-      .wea    (wren_bank0             ),
-      .addra  (addr_bank0             ),
-      .dina   (wdata_bank0            ),
-      .douta  (                       ),
-      .clkb   (clk                    ),
-      .web    ('0                     ),
-      .addrb  (lookup_pc_i[3+:9]      ),
-      .dinb   ('0                     ),
-      .doutb  ({btb_rst_m1_o.valid,
-                btb_rst_m1_o.is_jarl,
-                btb_rst_m1_o.pc,
-                btb_rst_m1_o.tgt}     )
-    );
+  genvar gb, gw;
+  generate
+    for(gb=0; gb<2; gb=gb+1) begin: gen_bank
+      //* update, ex first;
+      wire                  upd_ex    = btb_upd_v_ex_i & (btb_upd_ex_i.pc[2] == gb);
+      wire                  upd_d2    = btb_upd_v_d2_i & (btb_upd_d2_i.pc[2] == gb);
+      btb_t                 upd_entry;
+      assign                upd_entry = upd_ex? btb_upd_ex_i: btb_upd_d2_i;
+      wire  [SET_BITS-1:0]  upd_set   = upd_entry.pc[3+:SET_BITS];
+      wire  [28:0]          lookup_pair = lookup_pc_i[31:3] + ((gb == 0)? 29'(lookup_pc_i[2]): 29'd0);
+      reg   [28:0]          r_lookup_pair;
+      always_ff @(posedge clk) begin
+        r_lookup_pair       <= lookup_pair;
+      end
+      wire  [SET_BITS-1:0]  lookup_set= lookup_pair[0+:SET_BITS];
+      wire  [SET_BITS-1:0]  rd_set    = r_lookup_pair[0+:SET_BITS];
 
-    ram_34_512 btb_bank1(
-      .clka   (clk                    ),
-      .wea    (wren_bank1             ),
-      .addra  (addr_bank0             ),
-      .dina   (wdata_bank1            ),
-      .douta  (                       ),
-      .clkb   (clk                    ),
-      .web    ('0                     ),
-      .addrb  (lookup_pc_m1[3+:9]     ),
-      .dinb   ('0                     ),
-      .doutb  ({btb_rst_m0_o.valid,
-                btb_rst_m0_o.is_jarl,
-                btb_rst_m0_o.pc,
-                btb_rst_m0_o.tgt}     )
-    );
-  `elsif SIM_FIFO_RAM
-    syncram btb_bank0(
-      .address_a  (addr_bank0             ),
-      .address_b  (lookup_pc_i[3+:9]      ),
-      .clock      (clk                    ),
-      .data_a     (wdata_bank0            ),
-      .data_b     ('0                     ),
-      .rden_a     (                       ),
-      .rden_b     (1'b1                   ),
-      .wren_a     (wren_bank0             ),
-      .wren_b     ('0                     ),
-      .q_a        (                       ),
-      .q_b        ({btb_rst_m0_o.valid,
-                    btb_rst_m0_o.is_jarl,
-                    btb_rst_m0_o.pc,
-                    btb_rst_m0_o.tgt}     )
-    );
-    defparam  btb_bank0.BUFFER= 0,
-              btb_bank0.width = 34,
-              btb_bank0.depth = 9,
-              btb_bank0.words = 512;
-    syncram btb_bank1(
-      .address_a  (addr_bank1             ),
-      .address_b  (lookup_pc_m1[3+:9]     ),
-      .clock      (clk                    ),
-      .data_a     (wdata_bank1            ),
-      .data_b     ('0                     ),
-      .rden_a     (                       ),
-      .rden_b     (1'b1                   ),
-      .wren_a     (wren_bank1             ),
-      .wren_b     ('0                     ),
-      .q_a        (                       ),
-      .q_b        ({btb_rst_m1_o.valid,
-                    btb_rst_m1_o.is_jarl,
-                    btb_rst_m1_o.pc,
-                    btb_rst_m1_o.tgt}     )
-    );
-    defparam  btb_bank1.BUFFER= 0,
-              btb_bank1.width = 34,
-              btb_bank1.depth = 9,
-              btb_bank1.words = 512;
-  `endif
+      //* lru, way with the largest age is the victim;
+      reg   [WAY_BITS-1:0]  lru_age[NUM_SET-1:0][NUM_WAY-1:0];
+      logic [WAY_BITS-1:0]  lru_victim, upd_way, hit_way;
+      logic [NUM_WAY-1:0]   hit;
+      always_comb begin
+        lru_victim          = '0;
+        for(integer w=0; w<NUM_WAY; w=w+1)
+          if(lru_age[upd_set][w] == NUM_WAY-1)
+            lru_victim      = w;
+        upd_way             = upd_entry.hit_mbtb? upd_entry.way_mbtb: lru_victim;
+      end
+
+      reg                   wren;
+      reg   [WAY_BITS-1:0]  wr_way;
+      reg   [SET_BITS-1:0]  wr_set;
+      reg   [ENTRY_W-1:0]   wdata;
+      always_ff @(posedge clk) begin
+        wren                <= (upd_ex | upd_d2) & (state_btb == READY_S);
+        wr_way              <= upd_way;
+        wr_set              <= upd_set;
+        wdata               <= {upd_entry.valid, upd_entry.is_br, upd_entry.is_call, 
+                                upd_entry.is_ret, upd_entry.pc[31-:TAG_BITS], upd_entry.pc[1],
+                                upd_entry.tgt};
+      end
+
+      //* touch lru by write, or by lookup hit;
+      logic                 touch;
+      logic [SET_BITS-1:0]  touch_set;
+      logic [WAY_BITS-1:0]  touch_way;
+      always_comb begin
+        touch               = wren | (|hit);
+        touch_set           = wren? wr_set: rd_set;
+        touch_way           = wren? wr_way: hit_way;
+      end
+      always_ff @(posedge clk or negedge resetn_soc) begin
+        if(!resetn_soc) begin
+          for(integer i=0; i<NUM_SET; i=i+1)
+            for(integer w=0; w<NUM_WAY; w=w+1)
+              lru_age[i][w] <= w;
+        end
+        else if(touch) begin
+          for(integer w=0; w<NUM_WAY; w=w+1)
+            if(w == touch_way)
+              lru_age[touch_set][w] <= '0;
+            else if(lru_age[touch_set][w] < lru_age[touch_set][touch_way])
+              lru_age[touch_set][w] <= lru_age[touch_set][w] + 1;
+        end
+      end
+
+      //* ways;
+      wire  [ENTRY_W-1:0]   rdata[NUM_WAY-1:0];
+      for(gw=0; gw<NUM_WAY; gw=gw+1) begin: gen_way
+        wire                  wren_way  = (state_btb == IDLE_S) | wren & (wr_way == gw);
+        wire  [SET_BITS-1:0]  waddr_way = (state_btb == IDLE_S)? init_addr: wr_set;
+        wire  [ENTRY_W-1:0]   wdata_way = (state_btb == IDLE_S)? '0: wdata;
+        `ifdef XILINX_FIFO_RAM
+          //* built by ram_34_512 slices;
+          localparam NUM_SLICE = (ENTRY_W + 33) / 34;
+          wire  [NUM_SLICE*34-1:0]  wdata_pad = wdata_way;
+          wire  [NUM_SLICE*34-1:0]  rdata_pad;
+          assign rdata[gw] = rdata_pad[ENTRY_W-1:0];
+          for(genvar gs=0; gs<NUM_SLICE; gs=gs+1) begin: gen_slice
+            ram_34_512 btb_way(
+              .clka   (clk                          ),
+              .wea    (wren_way                     ),
+              .addra  (9'(waddr_way)                ),
+              .dina   (wdata_pad[gs*34+:34]         ),
+              .douta  (                             ),
+              .clkb   (clk                          ),
+              .web    ('0                           ),
+              .addrb  (9'(lookup_set)               ),
+              .dinb   ('0                           ),
+              .doutb  (rdata_pad[gs*34+:34]         )
+            );
+          end
+        `elsif SIM_FIFO_RAM
+          syncram btb_way(
+            .address_a  (waddr_way              ),
+            .address_b  (lookup_set             ),
+            .clock      (clk                    ),
+            .data_a     (wdata_way              ),
+            .data_b     ('0                     ),
+            .rden_a     (                       ),
+            .rden_b     (1'b1                   ),
+            .wren_a     (wren_way               ),
+            .wren_b     ('0                     ),
+            .q_a        (                       ),
+            .q_b        (rdata[gw]              )
+          );
+          defparam  btb_way.BUFFER= 0,
+                    btb_way.width = ENTRY_W,
+                    btb_way.depth = SET_BITS,
+                    btb_way.words = NUM_SET;
+        `endif
+        assign hit[gw] = rdata[gw][ENTRY_W-1] & 
+                          (rdata[gw][33+:TAG_BITS] == r_lookup_pair[28-:TAG_BITS]);
+      end
 
-endmodule
\ No newline at end of file
+      //* output the hit way;
+      btb_t                 btb_rst;
+      always_comb begin
+        hit_way             = '0;
+        for(integer w=0; w<NUM_WAY; w=w+1)
+          if(hit[w])
+            hit_way         = w;
+        btb_rst             = '0;
+        btb_rst.valid       = |hit;
+        btb_rst.is_br       = rdata[hit_way][ENTRY_W-2];
+        btb_rst.is_call     = rdata[hit_way][ENTRY_W-3];
+        btb_rst.is_ret      = rdata[hit_way][ENTRY_W-4];
+        btb_rst.pc          = {r_lookup_pair, 1'(gb), rdata[hit_way][32], 1'b0};
+        btb_rst.tgt         = rdata[hit_way][31:0];
+        btb_rst.hit_mbtb    = |hit;
+        btb_rst.way_mbtb    = hit_way;
+      end
+    end
+  endgenerate
+
+  assign btb_rst_m0_o = gen_bank[0].btb_rst;
+  assign btb_rst_m1_o = gen_bank[1].btb_rst;
+
+endmodule
@@ -3,6 +3,17 @@
 //  Authority @ lijunnan (lijunnan@nudt.edu.cn)
 //  Last edited time: 2024/06/26
 //  Function outline: load and store unit
+//  Note:
+//    1) lsq is in order, the data port returns rvalid 2 clks after gnt;
+//      loads not issued at d2 are reported by ld_late_o and parked, 
+//      later instrs keep issuing until meeting the rd (scoreboard);
+//    2) a load to a word covered by the older stores in lsq (issued but not
+//      finished) is forwarded by merging their bytes (wstrb), without
+//      accessing the data port; the result is returned 2 clks later, the
+//      same as the data port;
+//    3) lr/sc/amo (RV32A) is executed at memory side, and is sent only after
+//      all older accesses are returned (i.e., in flight alone); it is always
+//      a late load, and neither forwards to nor is forwarded by others;
 /*************************************************************/
 import NanoCore_pkg::*;
 
@@ -27,8 +38,12 @@ module N2_lsu (
   output  wire  [31:0]  data_addr_o,
   output  wire  [31:0]  data_wdata_o,
   output  wire  [ 3:0]  data_wstrb_o,
+  output  wire          data_amo_o,
+  output  wire  [ 4:0]  data_amo_op_o,
   input   wire          data_ready_i,
   input   wire  [31:0]  data_rdata_i,
+  output  wire          ld_late_o,        //* load is not returned 2 clks after d2
+  output  wire  [regindex_bits-1:0] ld_late_dst_o,
   output  wire          lsu_stall_idu_o
 );
 
@@ -54,25 +69,70 @@ module N2_lsu (
                               (lsu_ctl_idu.mem_wordsize == 'd1)? {2{alu_op2_i[15:0]}}: alu_op2_i;
   assign lsu_ctl_idu.wstrb = (lsu_ctl_idu.mem_wordsize == 'd2)? 4'b0001 << lsu_ctl_idu.addr[1:0]:
                               (lsu_ctl_idu.mem_wordsize == 'd1)? {{2{lsu_ctl_idu.addr[1]}},{2{~lsu_ctl_idu.addr[1]}}}: 4'b1111;;
-  assign lsu_ctl_idu.we = to_st_v_i;
+  assign lsu_ctl_idu.we = to_st_v_i | uop_ctl_i.is_amo & (uop_ctl_i.amo_op == AMO_SC);
   assign lsu_ctl_idu.is_lu = is_lbu_lhu_lw_i;
   assign lsu_ctl_idu.is_lh = instr_lh_i;
   assign lsu_ctl_idu.is_lb = instr_lb_i;
+  assign lsu_ctl_idu.is_amo = uop_ctl_i.is_amo;
+  assign lsu_ctl_idu.amo_op = uop_ctl_i.amo_op;
   assign lsu_ctl_idu.rf_dst = rf_dst_idu_i;
   assign lsu_ctl_idu.uid = uid_d2_i;
 
   wire   lsq_bypass = lsq_wr_ptr == lsq_fetch_ptr;
   wire [3:0] lsq_left = {~lsq_wr_ptr[2] & lsq_rd_ptr[2],lsq_wr_ptr} - {1'b0,lsq_rd_ptr};
   assign lsu_stall_idu_o = lsq_left[2];
+  //* load waits in lsq (or data port is busy), its rd is released by
+  //*   rf_we_lsu_o rather than by the 2-clk bypass;
+  assign ld_late_o      = to_ld_v_i & ~(lsq_bypass & data_gnt_i & ~uop_ctl_i.is_amo);
+  assign ld_late_dst_o  = rf_dst_idu_i;
   logic [31:0]  w_data_rdata;
+  wire          lsq_req = ~lsq_bypass | to_st_v_i | to_ld_v_i;
+  wire          amo_wait;
 
-  assign data_req_o   = ~lsq_bypass | to_st_v_i | to_ld_v_i;
+  //* store-to-load forwarding, merge the older stores to the same word in
+  //*   lsq (from oldest to youngest); only for memory (not peri), and not
+  //*   while a peri access is in flight as its rvalid is not 2 clks later;
+  wire  [2:0]   lsq_inflight = lsq_fetch_ptr - lsq_rd_ptr;
+  logic [3:0]   fwd_hit;
+  logic [31:0]  fwd_data;
+  logic         fwd_block;
+  wire          fwd_v = lsq_req & ~lsu_ctl_fetch.we & ~fwd_block & ~lsu_ctl_fetch.is_amo &
+                        (lsu_ctl_fetch.addr[31:28] == 4'b0) &
+                        ((fwd_hit & lsu_ctl_fetch.wstrb) == lsu_ctl_fetch.wstrb);
+  reg   [1:0]   r_fwd_v;
+  reg   [1:0][31:0] r_fwd_data;
+  wire          w_data_ready = data_ready_i | r_fwd_v[1];
+  wire  [31:0]  w_rdata = r_fwd_v[1]? r_fwd_data[1]: data_rdata_i;
+  always_comb begin
+    fwd_hit       = '0;
+    fwd_data      = '0;
+    fwd_block     = '0;
+    for(integer i=0; i<8; i=i+1) begin
+      if(i < lsq_inflight) begin
+        fwd_block = fwd_block | (lsq_entry[3'(lsq_rd_ptr+i)].addr[31:28] != 4'b0) |
+                                lsq_entry[3'(lsq_rd_ptr+i)].is_amo;
+        if(lsq_entry[3'(lsq_rd_ptr+i)].we && 
+            lsq_entry[3'(lsq_rd_ptr+i)].addr[31:2] == lsu_ctl_fetch.addr[31:2])
+          for(integer j=0; j<4; j=j+1)
+            if(lsq_entry[3'(lsq_rd_ptr+i)].wstrb[j]) begin
+              fwd_hit[j]        = 1'b1;
+              fwd_data[j*8+:8]  = lsq_entry[3'(lsq_rd_ptr+i)].wdata[j*8+:8];
+            end
+      end
+    end
+  end
+
+  //* atomic waits until older accesses are returned;
+  assign amo_wait     = lsu_ctl_fetch.is_amo & (lsq_inflight != 3'd0);
+  assign data_req_o   = lsq_req & ~fwd_v & ~amo_wait;
   assign data_addr_o  = lsu_ctl_fetch.addr;
   assign data_wdata_o = lsu_ctl_fetch.wdata;
   assign data_wstrb_o = lsu_ctl_fetch.wstrb & {4{lsu_ctl_fetch.we}};
   assign data_we_o    = lsu_ctl_fetch.we;
+  assign data_amo_o   = lsu_ctl_fetch.is_amo;
+  assign data_amo_op_o= lsu_ctl_fetch.amo_op;
   // assign rf_dst_lsu_ns_o  = lsu_ctl_fetch.rf_dst;
-  assign rf_we_lsu_o  = data_ready_i & ~lsu_ctl_rd.we;
+  assign rf_we_lsu_o  = w_data_ready & (~lsu_ctl_rd.we | lsu_ctl_rd.is_amo);
   assign rf_dst_lsu_o = lsu_ctl_rd.rf_dst;
   assign alu_rst_o    = {32{lsu_ctl_rd.is_lu}} & w_data_rdata |
                         {32{lsu_ctl_rd.is_lh}} & {{16{w_data_rdata[15]}},w_data_rdata[15:0]} |
@@ -85,9 +145,13 @@ module N2_lsu (
       lsq_wr_ptr        <= '0;
       lsq_fetch_ptr     <= '0;
       rf_we_lsu_ns_o    <= '0;
+      r_fwd_v           <= '0;
     end
     else begin
-      rf_we_lsu_ns_o    <= ~data_we_o & data_req_o;
+      rf_we_lsu_ns_o    <= ~data_we_o & lsq_req & ~lsu_ctl_fetch.is_amo;
+      //* forwarded load takes the slot of data port;
+      r_fwd_v           <= {r_fwd_v[0], fwd_v & data_gnt_i};
+      r_fwd_data        <= {r_fwd_data[0], fwd_data};
       rf_dst_lsu_ns_o   <= lsu_ctl_fetch.rf_dst;
       //* write lsq;
       if(to_st_v_i | to_ld_v_i) begin
@@ -96,7 +160,7 @@ module N2_lsu (
       end
       //* read/write data;
       // data_req          <= data_gnt_i? ~lsq_bypass: data_req_o;
-      lsq_fetch_ptr     <= (data_gnt_i & data_req_o)? (lsq_fetch_ptr + 1): lsq_fetch_ptr;
+      lsq_fetch_ptr     <= (data_gnt_i & lsq_req & ~amo_wait)? (lsq_fetch_ptr + 1): lsq_fetch_ptr;
       // if((to_st_v_i | to_ld_v_i | ~lsq_bypass ) & (data_gnt_i | ~data_req_o)) begin
       //   data_addr_o     <= lsu_ctl_fetch.addr;
       //   data_wdata_o    <= lsu_ctl_fetch.wdata;
@@ -107,7 +171,7 @@ module N2_lsu (
       // end
 
 
-      lsq_rd_ptr      <=  data_ready_i? (lsq_rd_ptr + 1): lsq_rd_ptr;
+      lsq_rd_ptr      <=  w_data_ready? (lsq_rd_ptr + 1): lsq_rd_ptr;
       // //* respond
       // rf_we_lsu_o       <= 1'b0;
       // if (data_ready_i) begin
@@ -127,19 +191,19 @@ module N2_lsu (
 
   always_comb begin
     case(lsu_ctl_rd.mem_wordsize)
-      0: w_data_rdata = data_rdata_i;
+      0: w_data_rdata = w_rdata;
       1: begin
         case (lsu_ctl_rd.addr[1])
-          1'b0: w_data_rdata = {16'b0, data_rdata_i[15: 0]};
-          1'b1: w_data_rdata = {16'b0, data_rdata_i[31:16]};
+          1'b0: w_data_rdata = {16'b0, w_rdata[15: 0]};
+          1'b1: w_data_rdata = {16'b0, w_rdata[31:16]};
         endcase
       end
       2: begin
         case (lsu_ctl_rd.addr[1:0])
-          2'b00: w_data_rdata = {24'b0, data_rdata_i[ 7: 0]};
-          2'b01: w_data_rdata = {24'b0, data_rdata_i[15: 8]};
-          2'b10: w_data_rdata = {24'b0, data_rdata_i[23:16]};
-          2'b11: w_data_rdata = {24'b0, data_rdata_i[31:24]};
+          2'b00: w_data_rdata = {24'b0, w_rdata[ 7: 0]};
+          2'b01: w_data_rdata = {24'b0, w_rdata[15: 8]};
+          2'b10: w_data_rdata = {24'b0, w_rdata[23:16]};
+          2'b11: w_data_rdata = {24'b0, w_rdata[31:24]};
         endcase
       end
     endcase
@@ -3,6 +3,14 @@
 //  Authority @ lijunnan (lijunnan@nudt.edu.cn)
 //  Last edited time: 2024/06/24
 //  Function outline: mul and div unit
+//  Note:
+//    1) mul is pipelined (2 clks) and accepts one instr per clk, Zbc
+//      clmul/clmulh/clmulr share the pipeline of mul;
+//    2) div runs in background, only one div is in flight (N2_idu_decode
+//      stalls the next div until div_ready_o), and its result waits while
+//      mul is writing back;
+//    3) rd is carried with each instr, scoreboard in N2_idu_decode stalls
+//      only the instrs reading/writing rd of mul/div;
 /*************************************************************/
 import NanoCore_pkg::*;
 
@@ -16,9 +24,10 @@ module N2_mu (
   input   wire  [31:0]  mu_rs1_i,
   input   wire  [31:0]  mu_rs2_i,
   output  wire          div_ready_o,
+  output  wire          mu_busy_o,    //* mul/div in flight, for hpm
 
   output  logic [31:0]  alu_rst_mu_o,
-  output  reg   [regindex_bits-1:0] rf_dst_mu_o,
+  output  logic [regindex_bits-1:0] rf_dst_mu_o,
   output  logic         rf_we_mu_o
 );
   
@@ -26,24 +35,28 @@ module N2_mu (
                             uop_ctl_i.instr_mulh, 
                             uop_ctl_i.instr_mulhsu, 
                             uop_ctl_i.instr_mulhu};
+  wire  [2:0]   clmul_op_i= {uop_ctl_i.instr_clmul,
+                            uop_ctl_i.instr_clmulh,
+                            uop_ctl_i.instr_clmulr};
   wire  [3:0]   div_op_i = {uop_ctl_i.instr_div, 
                             uop_ctl_i.instr_divu, 
                             uop_ctl_i.instr_rem, 
                             uop_ctl_i.instr_remu};
   wire  [regindex_bits-1:0] rf_dst_idu_i = uop_ctl_i.decoded_rd;
-  wire          div_ready, mul_ready;
+  wire          div_ready, mul_ready, mul_busy, div_busy;
   wire  [31:0]  mul_rd, div_rd;
-  assign        div_ready_o = div_ready;
+  wire  [regindex_bits-1:0] mul_dst, div_dst;
+  //* mul has priority to write back, div is finished when written back;
+  assign        div_ready_o = div_ready & ~mul_ready;
+  assign        mu_busy_o   = mul_busy | mul_ready | div_busy | div_ready;
   wire  [7:0]   mul_uid, div_uid;
 
-  always_ff @(posedge clk) begin
-    rf_dst_mu_o <= mul_div_v? rf_dst_idu_i: rf_dst_mu_o;
-  end
-
   always_comb begin
     rf_we_mu_o = div_ready | mul_ready;
     alu_rst_mu_o = mul_ready? mul_rd : 
                 div_ready? div_rd : 32'b0;
+    rf_dst_mu_o= mul_ready? mul_dst : 
+                  div_ready? div_dst : '0;
     uid_mu_o   = mul_ready? mul_uid : 
                   div_ready? div_uid : 32'b0;
   end
@@ -53,29 +66,38 @@ module N2_mu (
     .resetn     (resetn         ),
     .mul_valid  (mul_div_v      ),
     .mul_op     (mul_op_i       ),
+    .clmul_op   (clmul_op_i     ),
     .mul_rs1    (mu_rs1_i       ),
     .mul_rs2    (mu_rs2_i       ),
     .mul_wr     (               ),
     .uid_i      (uid_d2_i       ),
+    .dst_i      (rf_dst_idu_i   ),
     .mul_rd     (mul_rd         ),
     .mul_uid    (mul_uid        ),
-    .mul_wait   (               ),
+    .mul_dst    (mul_dst        ),
+    .mul_wait   (mul_busy       ),
     .mul_ready  (mul_ready      )
   );
 
   //* for div
-  alu_div alu_div (
+  alu_div #(
+    .DIV_BITS   (`DIV_BITS      )
+  ) alu_div (
     .clk        (clk            ),
     .resetn     (resetn         ),
     .div_valid  (mul_div_v      ),
     .div_op     (div_op_i       ),
     .div_rs1    (mu_rs1_i       ),
     .div_rs2    (mu_rs2_i       ),
+    .div_hold   (mul_ready      ),
     .div_wr     (               ),
     .div_rd     (div_rd         ),
     .uid_i      (uid_d2_i       ),
     .div_uid    (div_uid        ),
+    .dst_i      (rf_dst_idu_i   ),
+    .div_dst    (div_dst        ),
     .div_wait   (               ),
+    .div_busy   (div_busy       ),
     .div_ready  (div_ready      )
   );
 
@@ -92,27 +114,44 @@ module alu_mul #(
 
   input                 mul_valid,
   input         [3:0]   mul_op,
+  input         [2:0]   clmul_op,   //* {clmul, clmulh, clmulr}
   input         [31:0]  mul_rs1,
   input         [31:0]  mul_rs2,
   output  wire          mul_wr,
   output  wire  [31:0]  mul_rd,
   input   wire  [7:0]   uid_i,
   output  wire  [7:0]   mul_uid,
+  input   wire  [regindex_bits-1:0] dst_i,
+  output  wire  [regindex_bits-1:0] mul_dst,
   output  wire          mul_wait,
   output  wire          mul_ready
 );
   wire instr_mul, instr_mulh, instr_mulhsu, instr_mulhu; //* from mul
   assign {instr_mul, instr_mulh, instr_mulhsu, instr_mulhu} = mul_op;
-  wire instr_any_mul = |mul_op && mul_valid;
+  wire instr_clmulh, instr_clmulr;
+  assign {instr_clmulh, instr_clmulr} = clmul_op[1:0];
+  wire instr_any_clmul = |clmul_op;
+  wire instr_any_mul = (|mul_op || instr_any_clmul) && mul_valid;
   wire instr_any_mulh = |{instr_mulh, instr_mulhsu, instr_mulhu};
   wire instr_rs1_signed = |{instr_mulh, instr_mulhsu};
   wire instr_rs2_signed = |{instr_mulh};
 
   reg shift_out, instr_any_mulh_delay;
+  //* clmul in stage 0 (selects carry-less product), {clmulh, clmulr} in stage 1;
+  reg cl_delay;
+  reg [1:0] cl_out, cl_op_delay;
   reg [3:0] active;
   reg [7:0] r_mul_uid[1:0];
+  reg [regindex_bits-1:0] r_mul_dst[1:0];
   reg [32:0] rs1, rs2, rs1_q, rs2_q;
   reg [63:0] rd, rd_q;
+  logic [63:0] cl_rd;
+  always_comb begin
+    cl_rd = '0;
+    for(integer i=0; i<32; i=i+1)
+      if(rs2[i])
+        cl_rd = cl_rd ^ ({32'b0, rs1[31:0]} << i);
+  end
 
   wire mul_insn_valid = mul_valid && instr_any_mul;
   reg mul_insn_valid_q;
@@ -124,7 +163,8 @@ module alu_mul #(
       rs2_q <= rs2;
     end
     if (!MUL_CLKGATE || active[1]) begin
-      rd <= $signed(EXTRA_MUL_FFS ? rs1_q : rs1) * $signed(EXTRA_MUL_FFS ? rs2_q : rs2);
+      rd <= cl_delay? cl_rd:
+            $signed(EXTRA_MUL_FFS ? rs1_q : rs1) * $signed(EXTRA_MUL_FFS ? rs2_q : rs2);
     end
     if (!MUL_CLKGATE || active[2]) begin
       rd_q <= rd;
@@ -132,7 +172,8 @@ module alu_mul #(
   end
 
   always_ff @(posedge clk) begin
-    if (instr_any_mul && !(EXTRA_MUL_FFS ? active[3:0] : active[1:0])) begin
+    //* accept one mul per clk;
+    if (instr_any_mul) begin
       if (instr_rs1_signed)
         rs1 <= $signed(mul_rs1);
       else
@@ -144,95 +185,152 @@ module alu_mul #(
         rs2 <= $unsigned(mul_rs2);
       active[0] <= 1;
       r_mul_uid[0]  <= uid_i;
+      r_mul_dst[0]  <= dst_i;
     end else begin
       active[0] <= 0;
     end
 
     active[3:1] <= active;
     r_mul_uid[1]  <= r_mul_uid[0];
+    r_mul_dst[1]  <= r_mul_dst[0];
     {shift_out,instr_any_mulh_delay} <= {instr_any_mulh_delay,instr_any_mulh};
+    cl_delay    <= instr_any_clmul;
+    {cl_out,cl_op_delay} <= {cl_op_delay,instr_clmulh,instr_clmulr};
 
     if (!resetn)
       active <= 0;
   end
 
   assign mul_wr = active[EXTRA_MUL_FFS ? 3 : 1];
-  assign mul_wait = 0;
+  assign mul_wait = active[0];  //* accepted, not ready yet
   assign mul_ready = active[EXTRA_MUL_FFS ? 3 : 1];
   assign mul_uid = r_mul_uid[1];
-  assign mul_rd = shift_out ? (EXTRA_MUL_FFS ? rd_q : rd) >> 32 : (EXTRA_MUL_FFS ? rd_q : rd);
+  assign mul_dst = r_mul_dst[1];
+  wire [63:0] mul_p = EXTRA_MUL_FFS ? rd_q : rd;
+  assign mul_rd = cl_out[1] ? mul_p[63:32] : cl_out[0] ? mul_p[62:31] :
+                  shift_out ? mul_p >> 32 : mul_p;
 endmodule
 
 
-module alu_div (
+//* div retiring DIV_BITS quotient bits per clk (DIV_BITS = 1 is bit-serial);
+//*   1) only the quotient bits above the divisor's msb are computed (early-out
+//*     for small dividend), rounded up to DIV_BITS;
+//*   2) divide-by-zero and |rs1| < |rs2| take the short path (2 clks);
+module alu_div #(
+  parameter DIV_BITS = 4      //* 1/2/4/8, less is smaller but slower
+) (
   input clk, resetn,
 
   input                 div_valid,
   input         [3:0]   div_op,
   input         [31:0]  div_rs1,
   input         [31:0]  div_rs2,
+  input   wire          div_hold,   //* keep result while mul is writing back
   input   wire  [7:0]   uid_i,
   output  reg   [7:0]   div_uid,
+  input   wire  [regindex_bits-1:0] dst_i,
+  output  reg   [regindex_bits-1:0] div_dst,
   output  reg           div_wr,
   output  reg   [31:0]  div_rd,
   output  wire          div_wait,
+  output  wire          div_busy,
   output  reg           div_ready
 );
-  reg instr_div, instr_divu, instr_rem, instr_remu;
-  // wire instr_div, instr_divu, instr_rem, instr_remu;
-  // assign {instr_div, instr_divu, instr_rem, instr_remu} = div_op;
+  wire instr_div, instr_divu, instr_rem, instr_remu;
+  assign {instr_div, instr_divu, instr_rem, instr_remu} = div_op;
+  reg  is_div;    //* latched at start, 1: div/divu, 0: rem/remu
 
   reg div_wait_q;
   assign div_wait = (|div_op) && resetn && div_valid;
   wire start = div_wait && !div_wait_q;
 
   always @(posedge clk) begin
-    // div_wait    <= (|div_op) && resetn && div_valid;
     div_wait_q  <= div_wait && resetn;
-    {instr_div, instr_divu, instr_rem, instr_remu} <= div_valid? div_op: 
-                  {instr_div, instr_divu, instr_rem, instr_remu};
   end
 
-  reg [31:0] dividend;
-  reg [62:0] divisor;
-  reg [31:0] quotient;
-  reg [31:0] quotient_msk;
-  reg running;
-  reg outsign;
+  //* operands at start;
+  wire          is_signed = instr_div || instr_rem;
+  wire  [31:0]  abs_rs1 = is_signed && div_rs1[31] ? -div_rs1 : div_rs1;
+  wire  [31:0]  abs_rs2 = is_signed && div_rs2[31] ? -div_rs2 : div_rs2;
+  logic [5:0]   nbits_rs1, nbits_rs2;   //* position of msb + 1
+  always_comb begin
+    nbits_rs1 = 6'd0;
+    nbits_rs2 = 6'd0;
+    for(integer i=0; i<32; i=i+1) begin
+      if(abs_rs1[i]) nbits_rs1 = 6'(i+1);
+      if(abs_rs2[i]) nbits_rs2 = 6'(i+1);
+    end
+  end
+  wire          short_path = ~(|abs_rs2) || (nbits_rs1 < nbits_rs2);
+  wire  [5:0]   n_qbits = nbits_rs1 - nbits_rs2 + 6'd1;
+  wire  [5:0]   n_qbits_r = 6'((n_qbits + DIV_BITS - 1) & ~(DIV_BITS - 1));
+
+  //* rem holds the partial remainder, quo holds the unused dividend bits 
+  //*   (high part) and the quotient bits (low part);
+  reg   [31:0]  divisor, rem, quo;
+  reg   [5:0]   cnt;
+  reg           running;
+  assign        div_busy = running;
+  reg           outsign;
+  logic [32:0]  rem_step;
+  logic [31:0]  quo_step;
+  always_comb begin
+    rem_step    = {1'b0, rem};
+    quo_step    = quo;
+    for(integer i=0; i<DIV_BITS; i=i+1) begin
+      rem_step  = {rem_step[31:0], quo_step[31]};
+      quo_step  = {quo_step[30:0], 1'b0};
+      if(rem_step >= {1'b0, divisor}) begin
+        rem_step    = rem_step - {1'b0, divisor};
+        quo_step[0] = 1'b1;
+      end
+    end
+  end
 
   always_ff @(posedge clk) begin
-    div_ready     <= 'b0;
-    div_wr        <= 'b0;
-    div_rd        <= 'bx;
-    div_uid       <= (div_valid & (|div_op))? uid_i: div_uid;
+    div_ready     <= div_ready & div_hold;
+    div_wr        <= div_wr & div_hold;
+    div_rd        <= (div_ready & div_hold)? div_rd: 'bx;
+    div_uid       <= start? uid_i: div_uid;
+    div_dst       <= start? dst_i: div_dst;
 
     if (!resetn) begin
       running     <= 'b0;
+      div_ready   <= 'b0;
+      div_wr      <= 'b0;
     end else
     if (start) begin
       running     <= 'b1;
-      dividend    <= (instr_div || instr_rem) && div_rs1[31] ? -div_rs1 : div_rs1;
-      divisor     <= ((instr_div || instr_rem) && div_rs2[31] ? -div_rs2 : div_rs2) << 31;
+      is_div      <= instr_div || instr_divu;
+      divisor     <= abs_rs2;
       outsign     <= (instr_div && (div_rs1[31] != div_rs2[31]) && |div_rs2) || (instr_rem && div_rs1[31]);
-      quotient    <= 'b0;
-      quotient_msk<= 1 << 31;
+      if (short_path) begin
+        //* quotient is all ones for divide-by-zero, otherwise zero;
+        rem       <= abs_rs1;
+        quo       <= {32{~(|abs_rs2)}};
+        cnt       <= 'b0;
+      end
+      else begin
+        rem       <= abs_rs1 >> n_qbits_r;
+        quo       <= abs_rs1 << (6'd32 - n_qbits_r);
+        cnt       <= n_qbits_r;
+      end
     end else
-    if (!quotient_msk && running) begin
+    if (running && cnt <= DIV_BITS) begin
+      //* last step (or short path) writes back directly;
       running     <= 'b0;
       div_ready   <= 'b1;
       div_wr      <= 'b1;
 
-      if (instr_div || instr_divu)
-        div_rd    <= outsign ? -quotient : quotient;
+      if (is_div)
+        div_rd    <= outsign ? -(cnt? quo_step: quo) : (cnt? quo_step: quo);
       else
-        div_rd    <= outsign ? -dividend : dividend;
-    end else begin
-      if (divisor <= dividend) begin
-        dividend  <= dividend - divisor;
-        quotient  <= quotient | quotient_msk;
-      end
-      divisor     <= divisor >> 1;
-      quotient_msk<= quotient_msk >> 1;
+        div_rd    <= outsign ? -(cnt? rem_step[31:0]: rem) : (cnt? rem_step[31:0]: rem);
+    end else
+    if (running) begin
+      rem         <= rem_step[31:0];
+      quo         <= quo_step;
+      cnt         <= cnt - 6'(DIV_BITS);
     end
   end
-endmodule
\ No newline at end of file
+endmodule
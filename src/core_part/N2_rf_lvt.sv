@@ -0,0 +1,74 @@
+/*************************************************************/
+//  Module name: N2_rf_lvt
+//  Authority @ lijunnan (lijunnan@nudt.edu.cn)
+//  Last edited time: 2024/07/10
+//  Function outline: multi-port register file, LVT-based banking
+//  Note:
+//    1) each write port owns one bank, and each bank keeps one copy
+//      per read port, i.e., all rams are 1W1R (LUTRAM, async read);
+//    2) live value table (lvt) records the last port that wrote
+//      each reg, read data is selected by lvt;
+//    3) write ports in the same clk with the same addr are resolved
+//      by priority, port 0 is the highest (same as flop-based rf);
+/*************************************************************/
+import NanoCore_pkg::*;
+
+module N2_rf_lvt #(
+  parameter NUM_WR  = 5,
+  parameter NUM_RD  = 4,
+  parameter AW      = 5
+) (
+  input clk,
+
+  input   wire  [NUM_WR-1:0]          wr_en_i,
+  input   wire  [NUM_WR-1:0][AW-1:0]  wr_addr_i,
+  input   wire  [NUM_WR-1:0][31:0]    wr_data_i,
+  input   wire  [NUM_RD-1:0][AW-1:0]  rd_addr_i,
+  output  logic [NUM_RD-1:0][31:0]    rd_data_o
+);
+
+  localparam LW = $clog2(NUM_WR);
+
+  //* bank[w][r]: written by port w, read by port r;
+  (* ram_style = "distributed" *)
+  reg   [31:0]    bank    [NUM_WR-1:0][NUM_RD-1:0][0:(1<<AW)-1];
+  reg   [LW-1:0]  lvt     [0:(1<<AW)-1];
+
+  //* a write port is masked if a higher-priority port writes the same reg;
+  logic [NUM_WR-1:0]  wr_en;
+  always_comb begin
+    wr_en = wr_en_i;
+    for(integer w=1; w<NUM_WR; w=w+1)
+      for(integer h=0; h<w; h=h+1)
+        if(wr_en_i[h] & (wr_addr_i[h] == wr_addr_i[w]))
+          wr_en[w] = 1'b0;
+  end
+
+  //* write banks, data copies are not masked (lvt points to the winner);
+  always_ff @(posedge clk) begin
+    for(integer w=0; w<NUM_WR; w=w+1)
+      for(integer r=0; r<NUM_RD; r=r+1)
+        if(wr_en_i[w])
+          bank[w][r][wr_addr_i[w]] <= wr_data_i[w];
+  end
+
+  //* write lvt
+  always_ff @(posedge clk) begin
+    for(integer w=0; w<NUM_WR; w=w+1)
+      if(wr_en[w])
+        lvt[wr_addr_i[w]] <= LW'(w);
+  end
+
+  //* read, lvt selects the bank;
+  always_comb begin
+    for(integer r=0; r<NUM_RD; r=r+1)
+      rd_data_o[r] = bank[lvt[rd_addr_i[r]]][r][rd_addr_i[r]];
+  end
+
+  //* rf is not reset, lvt is initialized for sim only;
+  initial begin
+    for(integer i=0; i<(1<<AW); i=i+1)
+      lvt[i] = '0;
+  end
+
+endmodule
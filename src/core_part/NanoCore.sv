@@ -25,6 +25,8 @@ module NanoCore #(
   output  wire  [31:0]  data_addr_o,
   output  wire  [ 3:0]  data_wstrb_o,
   output  wire  [31:0]  data_wdata_o,
+  output  wire          data_amo_o,       //* lr/sc/amo, executed at memory side
+  output  wire  [ 4:0]  data_amo_op_o,
   input   wire          data_ready_ns_i,
   input   wire          data_ready_i,
   input   wire  [31:0]  data_rdata_i,
@@ -33,16 +35,29 @@ module NanoCore #(
   output  wire          instr_req_o,    //* ahead of instr_req_2b_o;
   output  wire  [ 1:0]  instr_req_2b_o,
   output  wire  [31:0]  instr_addr_o,
+  output  wire          instr_prefetch_req_o,
+  output  wire  [31:0]  instr_prefetch_addr_o,
   input   wire  [ 1:0]  instr_ready_i,
   input   wire  [63:0]  instr_rdata_i,
 
   input         [31:0]  i_irq,
   output  wire          o_irq_ack,
   output  wire  [4:0]   o_irq_id
+`ifdef ENABLE_HPM
+  ,
+  input   wire          instr_miss_i,
+  input   wire          data_miss_i,
+  output  wire  [(`HPM_NUM+2)*64-1:0] hpm_cnt_o  //* {mhpmcounter3~, instret, cycle}
+`endif
 );
 
   wire  [63:0]  count_cycle, count_instr;
-  wire  [31:0]  reg_pc_d1, cur_pc_d2, pc_2ex_d2, cur_pc_ex0, cur_pc_ex1;
+  wire          mu_busy;
+`ifdef ENABLE_HPM
+  wire  [`HPM_NUM-1:0][63:0] hpm_cnt;
+  assign hpm_cnt_o = {hpm_cnt, count_instr, count_cycle};
+`endif
+  wire  [31:0]  reg_pc_d1, link_pc_d2, pc_2ex_d2, cur_pc_ex0, cur_pc_ex1;
   wire  [31:0]  alu_op1_2ex0_d2, alu_op2_2ex0_d2,
                 alu_op1_2ex1_d2, alu_op2_2ex1_d2,
                 alu_op1_2mu_d2, alu_op2_2mu_d2,
@@ -54,7 +69,21 @@ module NanoCore #(
   //* iq pointer
   wire  [ 2:0]  iq_prefetch_ptr, iq_rd_ptr;
   //* register file
-  reg   [31:0]  cpuregs [0:regfile_size-1];
+`ifdef ENABLE_IRQ_SHADOW
+  //* x1 & x5~x31 are banked, bank 1 is used by irq handler; x2~x4 (sp/gp/tp) 
+  //*   are shared, i.e., the handler runs on the stack of interrupted code;
+  localparam    RF_AW = regindex_bits + 1;
+  wire          rf_bank;
+  function automatic [regindex_bits:0] rf_idx(input bank, input [regindex_bits-1:0] idx);
+    rf_idx = {bank & ((idx == 5'd1) | (idx > 5'd4)), idx};
+  endfunction
+`else
+  localparam    RF_AW = regindex_bits;
+  wire          rf_bank = 1'b0;
+  function automatic [regindex_bits-1:0] rf_idx(input bank, input [regindex_bits-1:0] idx);
+    rf_idx = idx;
+  endfunction
+`endif
   //* uop_ctl_idu_d1 used to read register file
   //* uop_ctl_idu sent to executor
   uop_ctl_t uop_ctl_m0_d1, uop_ctl_m0_d2, 
@@ -65,14 +94,17 @@ module NanoCore #(
   wire div_ready;
   
   wire is_branch_d2, is_branch_ex, is_branch_ex0, is_branch_ex1;
+  //* redirect_d1 (direct jump) only refetches, it is cancelled by older flush;
+  wire redirect_d1;
   assign is_branch_ex = is_branch_ex0 | is_branch_ex1;
   assign branch_pc_ex = is_branch_ex0? branch_pc_ex0: branch_pc_ex1;
-  assign flush_o = is_branch_d2 | is_branch_ex;
+  assign flush_o = is_branch_d2 | is_branch_ex | redirect_d1;
   logic [31:0]  branch_pc;
   always_comb begin
-    casez({is_branch_d2,is_branch_ex})
-      2'b?1: branch_pc   = branch_pc_ex & ~1;
-      2'b10: branch_pc   = branch_pc_d2 & ~1;
+    casez({is_branch_d2,is_branch_ex,redirect_d1})
+      3'b?1?: branch_pc  = branch_pc_ex & ~1;
+      3'b10?: branch_pc  = branch_pc_d2 & ~1;
+      3'b001: branch_pc  = branch_pc_d1 & ~1;
       default: branch_pc = '0;
     endcase
   end
@@ -83,31 +115,69 @@ module NanoCore #(
                             rf_dst_lsu_ns, rf_dst_lsu, rf_dst_mu;
   reg   [31:0]  cpuregs_rs1_m0,cpuregs_rs2_m0,cpuregs_rs1_m1,cpuregs_rs2_m1;
 
+  //* rf data read at d1 (before bypass), {rs2_m1, rs1_m1, rs2_m0, rs1_m0};
+  wire  [3:0][RF_AW-1:0]  rf_rd_addr;
+  wire  [3:0][31:0]       rf_rd_data;
+  assign rf_rd_addr = {rf_idx(rf_bank, uop_ctl_m1_d1.decoded_rs2), rf_idx(rf_bank, uop_ctl_m1_d1.decoded_rs1),
+                       rf_idx(rf_bank, uop_ctl_m0_d1.decoded_rs2), rf_idx(rf_bank, uop_ctl_m0_d1.decoded_rs1)};
+
+`ifdef RF_LVT
+  //* write ports {mu, lsu, ex1, ex0, d2}, port 0 has the highest priority;
+  //*   the jal/jalr link shares the port with its stage;
+  wire  [4:0]             rf_wr_en;
+  wire  [4:0][RF_AW-1:0]  rf_wr_addr;
+  wire  [4:0][31:0]       rf_wr_data;
+  assign rf_wr_en   = { rf_we_mu, rf_we_lsu,
+                        rf_we_ex1,
+                        rf_we_ex0,
+                       ~is_branch_ex  & (rf_we_d2 | is_branch_d2)};
+  assign rf_wr_addr = { rf_idx(rf_bank, rf_dst_mu),  rf_idx(rf_bank, rf_dst_lsu),
+                        rf_idx(rf_bank, rf_dst_ex1), rf_idx(rf_bank, rf_dst_ex0),
+                        rf_idx(rf_bank, rf_dst_d2)};
+  assign rf_wr_data = { alu_rst_mu, alu_rst_lsu,
+                        alu_rst_ex1,
+                        alu_rst_ex0,
+                        rf_we_d2?      alu_rst_idu: link_pc_d2};
+
+  N2_rf_lvt #(
+    .NUM_WR           (5                ),
+    .NUM_RD           (4                ),
+    .AW               (RF_AW            )
+  ) u_rf_lvt(
+    .clk              (clk              ),
+    .wr_en_i          (rf_wr_en         ),
+    .wr_addr_i        (rf_wr_addr       ),
+    .wr_data_i        (rf_wr_data       ),
+    .rd_addr_i        (rf_rd_addr       ),
+    .rd_data_o        (rf_rd_data       )
+  );
+`else
+  reg   [31:0]  cpuregs [0:(1<<RF_AW)-1];
+  assign rf_rd_data = {cpuregs[rf_rd_addr[3]], cpuregs[rf_rd_addr[2]],
+                       cpuregs[rf_rd_addr[1]], cpuregs[rf_rd_addr[0]]};
+
   //* write rf
   always_ff @(posedge clk) begin
     for(integer i=1; i<32; i=i+1) begin
       (* parallel_case *)
       case(1)
-        ~is_branch_ex  & rf_we_d2     & (rf_dst_d2 == i):   cpuregs[i] <= alu_rst_idu;
-        ~is_branch_ex  & is_branch_d2 & (rf_dst_d2 == i):   cpuregs[i] <= cur_pc_d2 + 4;
-        ~is_branch_ex0 & rf_we_ex0    & (rf_dst_ex0 == i):  cpuregs[i] <= alu_rst_ex0;
-         is_branch_ex0 &                (rf_dst_ex0 == i):  cpuregs[i] <= cur_pc_ex0 + 4;
-        ~is_branch_ex1 & rf_we_ex1    & (rf_dst_ex1 == i):  cpuregs[i] <= alu_rst_ex1;
-         is_branch_ex1 &                (rf_dst_ex1 == i):  cpuregs[i] <= cur_pc_ex1 + 4;
-         rf_we_lsu     &                (rf_dst_lsu == i):  cpuregs[i] <= alu_rst_lsu;
-         rf_we_mu      &                (rf_dst_mu == i):   cpuregs[i] <= alu_rst_mu;
-        default:                                            cpuregs[i] <= cpuregs[i];
+        ~is_branch_ex  & rf_we_d2     & (rf_dst_d2 == i):   cpuregs[rf_idx(rf_bank, 5'(i))] <= alu_rst_idu;
+        ~is_branch_ex  & is_branch_d2 & (rf_dst_d2 == i):   cpuregs[rf_idx(rf_bank, 5'(i))] <= link_pc_d2;
+         rf_we_ex0     &                (rf_dst_ex0 == i):  cpuregs[rf_idx(rf_bank, 5'(i))] <= alu_rst_ex0;
+         rf_we_ex1     &                (rf_dst_ex1 == i):  cpuregs[rf_idx(rf_bank, 5'(i))] <= alu_rst_ex1;
+         rf_we_lsu     &                (rf_dst_lsu == i):  cpuregs[rf_idx(rf_bank, 5'(i))] <= alu_rst_lsu;
+         rf_we_mu      &                (rf_dst_mu == i):   cpuregs[rf_idx(rf_bank, 5'(i))] <= alu_rst_mu;
+        default:                                            cpuregs[rf_idx(rf_bank, 5'(i))] <= cpuregs[rf_idx(rf_bank, 5'(i))];
       endcase
       // cpuregs[i] <= (~is_branch_ex && rf_we_d2 &&     rf_dst_d2 == i)?   alu_rst_idu:
-      //               (~is_branch_ex && is_branch_d2 && rf_dst_d2 == i)?  (cur_pc_d2 + 4):
-      //               (~is_branch_ex0 && rf_we_ex0 &&   rf_dst_ex0 == i)?  alu_rst_ex0:
-      //               (is_branch_ex0 &&                 rf_dst_ex0 == i)? (cur_pc_ex0 + 4):
-      //               (~is_branch_ex1 && rf_we_ex1 &&   rf_dst_ex1 == i)?  alu_rst_ex1:
-      //               (is_branch_ex1 &&                 rf_dst_ex1 == i)? (cur_pc_ex1 + 4):
+      //               (~is_branch_ex && is_branch_d2 && rf_dst_d2 == i)?   link_pc_d2:
+      //               (rf_we_ex0 &&                     rf_dst_ex0 == i)?  alu_rst_ex0:
+      //               (rf_we_ex1 &&                     rf_dst_ex1 == i)?  alu_rst_ex1:
       //               (rf_we_lsu &&                     rf_dst_lsu == i)?  alu_rst_lsu:
       //               (rf_we_mu &&                      rf_dst_mu == i)?   alu_rst_mu: cpuregs[i];
     end
   end
+`endif
 
   //* read rf at d1; {lsu,ex1,ex0}
   wire [1:0][2:0] alu_op_bypass_m0_d1, alu_op_bypass_m1_d1;
@@ -117,32 +187,28 @@ module NanoCore #(
       alu_op_bypass_m0_d1[0][0]: cpuregs_rs1_m0 = alu_rst_ex0;
       alu_op_bypass_m0_d1[0][1]: cpuregs_rs1_m0 = alu_rst_ex1;
       alu_op_bypass_m0_d1[0][2]: cpuregs_rs1_m0 = alu_rst_lsu;
-      default:                   cpuregs_rs1_m0 = uop_ctl_m0_d1.decoded_rs1 ? 
-                                      cpuregs[uop_ctl_m0_d1.decoded_rs1] : 'b0;
+      default:                   cpuregs_rs1_m0 = uop_ctl_m0_d1.decoded_rs1 ? rf_rd_data[0] : 'b0;
     endcase
     (* parallel_case *)
     case(1'b1)
       alu_op_bypass_m0_d1[1][0]: cpuregs_rs2_m0 = alu_rst_ex0;
       alu_op_bypass_m0_d1[1][1]: cpuregs_rs2_m0 = alu_rst_ex1;
       alu_op_bypass_m0_d1[1][2]: cpuregs_rs2_m0 = alu_rst_lsu;
-      default:                   cpuregs_rs2_m0 = uop_ctl_m0_d1.decoded_rs2 ? 
-                                      cpuregs[uop_ctl_m0_d1.decoded_rs2] : 'b0;
+      default:                   cpuregs_rs2_m0 = uop_ctl_m0_d1.decoded_rs2 ? rf_rd_data[1] : 'b0;
     endcase
     (* parallel_case *)
     case(1'b1)
       alu_op_bypass_m1_d1[0][0]: cpuregs_rs1_m1 = alu_rst_ex0;
       alu_op_bypass_m1_d1[0][1]: cpuregs_rs1_m1 = alu_rst_ex1;
       alu_op_bypass_m1_d1[0][2]: cpuregs_rs1_m1 = alu_rst_lsu;
-      default:                   cpuregs_rs1_m1 = uop_ctl_m1_d1.decoded_rs1 ? 
-                                      cpuregs[uop_ctl_m1_d1.decoded_rs1] : 'b0;
+      default:                   cpuregs_rs1_m1 = uop_ctl_m1_d1.decoded_rs1 ? rf_rd_data[2] : 'b0;
     endcase
     (* parallel_case *)
     case(1'b1)
       alu_op_bypass_m1_d1[1][0]: cpuregs_rs2_m1 = alu_rst_ex0;
       alu_op_bypass_m1_d1[1][1]: cpuregs_rs2_m1 = alu_rst_ex1;
       alu_op_bypass_m1_d1[1][2]: cpuregs_rs2_m1 = alu_rst_lsu;
-      default:                   cpuregs_rs2_m1 = uop_ctl_m1_d1.decoded_rs2 ? 
-                                      cpuregs[uop_ctl_m1_d1.decoded_rs2] : 'b0;
+      default:                   cpuregs_rs2_m1 = uop_ctl_m1_d1.decoded_rs2 ? rf_rd_data[3] : 'b0;
     endcase
 
     // cpuregs_rs1_m0 = alu_op_bypass_m0_d1[0][0]? alu_rst_ex0 : 
@@ -177,6 +243,8 @@ module NanoCore #(
   wire  [1:0]   uid_we_d2, uid_ready_we_d2;
   //* lsu is not ready
   wire          lsu_stall_idu;
+  wire          ld_late;
+  wire  [regindex_bits-1:0] ld_late_dst;
 
   wire  [31:0]  irq_mask;
   wire  [4:0]   irq_offset;
@@ -199,6 +267,24 @@ module NanoCore #(
   btb_ctl_t     btb_ctl_m0_ifu, btb_ctl_m1_ifu, btb_ctl_d2;
   assign btb_upd_v_ex = btb_upd_v_ex0 | btb_upd_v_ex1;
   assign btb_upd_info_ex = btb_upd_v_ex0? btb_upd_info_ex0: btb_upd_info_ex1;
+  //* ras checkpoint of the instr which causes flush;
+  ras_fix_t     ras_fix, ras_fix_d1, ras_fix_d2, ras_fix_ex0, ras_fix_ex1;
+  assign ras_fix = is_branch_ex0? ras_fix_ex0:
+                   is_branch_ex1? ras_fix_ex1: 
+                   is_branch_d2?  ras_fix_d2:  ras_fix_d1;
+  `ifdef ENABLE_HWLOOP
+    //* lp.* redirects at d2, cancelled by flush from exec;
+    wire        lp_upd_v_d2, lp_en;
+    lp_upd_t    lp_upd_d2;
+    wire        lp_upd_v = lp_upd_v_d2 & ~is_branch_ex;
+  `endif
+  `ifdef ENABLE_BHT
+    //* at most one conditional branch is executed in one clk;
+    wire        bht_upd_v_ex, bht_upd_v_ex0, bht_upd_v_ex1;
+    bht_upd_t   bht_upd_ex, bht_upd_ex0, bht_upd_ex1;
+    assign bht_upd_v_ex = bht_upd_v_ex0 | bht_upd_v_ex1;
+    assign bht_upd_ex   = bht_upd_v_ex0? bht_upd_ex0: bht_upd_ex1;
+  `endif
 `endif
 
   N2_ifu  
@@ -216,6 +302,8 @@ module NanoCore #(
     .instr_req_o      (instr_req_o      ),
     .instr_req_2b_o   (instr_req_2b_o   ),
     .instr_addr_o     (instr_addr_o     ),
+    .instr_prefetch_req_o (instr_prefetch_req_o ),
+    .instr_prefetch_addr_o(instr_prefetch_addr_o),
   `ifdef ENABLE_BP  
     .btb_upd_v_ex_i   (btb_upd_v_ex     ),
     .btb_upd_ex_i     (btb_upd_info_ex  ),
@@ -225,7 +313,16 @@ module NanoCore #(
     .btb_ctl_m0_o     (btb_ctl_m0_ifu   ),
     .btb_ctl_m1_v_o   (btb_ctl_m1_v_ifu ),
     .btb_ctl_m1_o     (btb_ctl_m1_ifu   ),
-    .cpuregs_x1       (cpuregs[1][15:0] ),
+    .ras_fix_i        (ras_fix          ),
+    `ifdef ENABLE_HWLOOP
+    .lp_upd_v_i       (lp_upd_v         ),
+    .lp_upd_i         (lp_upd_d2        ),
+    .lp_en_i          (lp_en            ),
+    `endif
+    `ifdef ENABLE_BHT
+    .bht_upd_v_ex_i   (bht_upd_v_ex     ),
+    .bht_upd_ex_i     (bht_upd_ex       ),
+    `endif
   `endif
     .iq_prefetch_ptr  (iq_prefetch_ptr  ),
     .iq_rd_ptr        (iq_rd_ptr        )
@@ -250,6 +347,8 @@ module NanoCore #(
     .alu_rst_d2_o     (alu_rst_idu      ),
     .is_branch_d2_o   (is_branch_d2     ),
     .branch_pc_d2_o   (branch_pc_d2     ),
+    .redirect_d1_o    (redirect_d1      ),
+    .branch_pc_d1_o   (branch_pc_d1     ),
 
     .alu_op1_2ex0_d2_o(alu_op1_2ex0_d2  ),
     .alu_op2_2ex0_d2_o(alu_op2_2ex0_d2  ),
@@ -281,7 +380,7 @@ module NanoCore #(
     .uid_2mu_d2_o     (uid_2mu_d2       ),
     .uid_2lsu_d2_o    (uid_2lsu_d2      ),
   `endif
-    .pc_d2_o          (cur_pc_d2        ),
+    .link_pc_d2_o     (link_pc_d2       ),
     .pc_2ex_d2_o      (pc_2ex_d2        ),
     // .pc_d1_o          (reg_pc_d1        ),
 
@@ -311,6 +410,8 @@ module NanoCore #(
     .lsu_finish_i     (data_ready_i     ),
     .mu_finish_i      (div_ready        ),
     .lsu_stall_idu_i  (lsu_stall_idu    ),
+    .ld_late_i        (ld_late          ),
+    .ld_late_dst_i    (ld_late_dst      ),
 
   `ifdef ENABLE_BP
     .btb_ctl_m0_v_i   (btb_ctl_m0_v_ifu ),
@@ -320,11 +421,27 @@ module NanoCore #(
     .btb_ctl_d2_o     (btb_ctl_d2       ),
     .btb_upd_v_d1_o   (btb_upd_v_d2     ),
     .btb_upd_d1_o     (btb_upd_d2       ),
+    .ras_fix_d1_o     (ras_fix_d1       ),
+    .ras_fix_d2_o     (ras_fix_d2       ),
+    `ifdef ENABLE_HWLOOP
+    .lp_upd_v_d2_o    (lp_upd_v_d2      ),
+    .lp_upd_d2_o      (lp_upd_d2        ),
+    .lp_en_o          (lp_en            ),
+    `endif
   `endif
     .alu_rst_ex0_i    (alu_rst_ex0      ),
     .alu_rst_ex1_i    (alu_rst_ex1      ),
     .alu_rst_lsu_i    (alu_rst_lsu      ),
 
+  `ifdef ENABLE_HPM
+    .icache_miss_i    (instr_miss_i     ),
+    .dcache_miss_i    (data_miss_i      ),
+    .mu_busy_i        (mu_busy          ),
+    .hpm_cnt_o        (hpm_cnt          ),
+  `endif
+  `ifdef ENABLE_IRQ_SHADOW
+    .rf_bank_o        (rf_bank          ),
+  `endif
     .count_cycle_o    (count_cycle      ),
     .count_instr_o    (count_instr      )
   );
@@ -350,6 +467,11 @@ N2_exec u_exec0(
   .btb_upd_v_o      (btb_upd_v_ex0    ),
   .btb_upd_info_o   (btb_upd_info_ex0 ),
   .btb_ctl_i        (btb_ctl_d2       ),
+  .ras_fix_o        (ras_fix_ex0      ),
+  `ifdef ENABLE_BHT
+  .bht_upd_v_o      (bht_upd_v_ex0    ),
+  .bht_upd_o        (bht_upd_ex0      ),
+  `endif
 `endif
 
   .cur_pc_d2_i      (pc_2ex_d2        ),
@@ -377,6 +499,11 @@ N2_exec u_exec1(
   .btb_upd_v_o      (btb_upd_v_ex1    ),
   .btb_upd_info_o   (btb_upd_info_ex1 ),
   .btb_ctl_i        (btb_ctl_d2       ),
+  .ras_fix_o        (ras_fix_ex1      ),
+  `ifdef ENABLE_BHT
+  .bht_upd_v_o      (bht_upd_v_ex1    ),
+  .bht_upd_o        (bht_upd_ex1      ),
+  `endif
 `endif
 
   .cur_pc_d2_i      (pc_2ex_d2        ),
@@ -404,10 +531,14 @@ N2_lsu u_lsu(
   .data_addr_o      (data_addr_o      ),
   .data_wstrb_o     (data_wstrb_o     ),
   .data_wdata_o     (data_wdata_o     ),
+  .data_amo_o       (data_amo_o       ),
+  .data_amo_op_o    (data_amo_op_o    ),
   .data_ready_i     (data_ready_i     ),
   .data_rdata_i     (data_rdata_i     ),
   
   .rf_we_lsu_o      (rf_we_lsu        ),
+  .ld_late_o        (ld_late          ),
+  .ld_late_dst_o    (ld_late_dst      ),
   .lsu_stall_idu_o  (lsu_stall_idu    )
 );
 
@@ -425,7 +556,8 @@ N2_mu u_mu (
   .uid_mu_o         (uid_mu           ),
   .alu_rst_mu_o     (alu_rst_mu       ),
   .rf_dst_mu_o      (rf_dst_mu        ),
-  .rf_we_mu_o       (rf_we_mu         )
+  .rf_we_mu_o       (rf_we_mu         ),
+  .mu_busy_o        (mu_busy          )
 );
 
 
@@ -480,8 +612,8 @@ N2_mu u_mu (
     //   $fwrite(out_file_w_clk, "latched_rd: %08x, data:%08x, clk:%08x\n", rf_dst_d2, alu_rst_idu, cnt_clk);
     // end
     // if(~is_branch_ex & is_branch_d2 & |rf_dst_d2) begin
-    //   $fwrite(out_file, "latched_rd: %08x, data:%08x\n", rf_dst_d2, cur_pc_d2 + 4);
-    //   $fwrite(out_file_w_clk, "latched_rd: %08x, data:%08x, clk:%08x\n", rf_dst_d2, cur_pc_d2 + 4, cnt_clk);
+    //   $fwrite(out_file, "latched_rd: %08x, data:%08x\n", rf_dst_d2, link_pc_d2);
+    //   $fwrite(out_file_w_clk, "latched_rd: %08x, data:%08x, clk:%08x\n", rf_dst_d2, link_pc_d2, cnt_clk);
     // end
     // if(cnt_clk == 32'hbd5d) begin
     //   $fclose(out_file);
@@ -506,7 +638,7 @@ N2_mu u_mu (
             if(wb_entry[i].uid == uid_ex0) begin
               wb_entry[i].ready     <= 1'b1;
               wb_entry[i].rf_dst    <= rf_dst_ex0;
-              wb_entry[i].rf_wdata  <= cur_pc_ex0 + 4;
+              wb_entry[i].rf_wdata  <= alu_rst_ex0;
             end
           end
         end
@@ -517,7 +649,7 @@ N2_mu u_mu (
             if(wb_entry[i].uid == uid_ex1) begin
               wb_entry[i].ready     <= 1'b1;
               wb_entry[i].rf_dst    <= rf_dst_ex1;
-              wb_entry[i].rf_wdata  <= cur_pc_ex1 + 4;
+              wb_entry[i].rf_wdata  <= alu_rst_ex1;
             end
           end
         end
@@ -531,7 +663,7 @@ N2_mu u_mu (
               if(i == wb_entry_wr_ptr) begin
                 wb_entry[i].ready   <= 1'b1;
                 wb_entry[i].rf_dst  <= rf_dst_d2;
-                wb_entry[i].rf_wdata<= is_branch_d2? (cur_pc_d2 + 4): alu_rst_idu;
+                wb_entry[i].rf_wdata<= is_branch_d2? link_pc_d2: alu_rst_idu;
               end
             end
           end
@@ -546,7 +678,7 @@ N2_mu u_mu (
                 if(i == wb_entry_wr_ptr_nxt) begin
                   wb_entry[i].ready   <= 1'b1;
                   wb_entry[i].rf_dst  <= rf_dst_d2;
-                  wb_entry[i].rf_wdata<= is_branch_d2? (cur_pc_d2 + 4): alu_rst_idu;
+                  wb_entry[i].rf_wdata<= is_branch_d2? link_pc_d2: alu_rst_idu;
                 end
               end
             end
@@ -555,7 +687,7 @@ N2_mu u_mu (
                 if(i == wb_entry_wr_ptr) begin
                   wb_entry[i].ready   <= 1'b1;
                   wb_entry[i].rf_dst  <= rf_dst_d2;
-                  wb_entry[i].rf_wdata<= is_branch_d2? (cur_pc_d2 + 4): alu_rst_idu;
+                  wb_entry[i].rf_wdata<= is_branch_d2? link_pc_d2: alu_rst_idu;
                 end
               end
             end
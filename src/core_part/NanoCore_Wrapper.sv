@@ -17,6 +17,10 @@ module NanoCore_Wrapper#(
   output wire   [31:0]  data_addr_o,
   output wire   [ 3:0]  data_wstrb_o,
   output wire   [31:0]  data_wdata_o,
+  output wire           data_amo_o,
+  output wire   [ 4:0]  data_amo_op_o,
+  output wire           data_fence_o,     //* drain buffered stores (ENABLE_WCB)
+  input  wire           data_wcb_empty_i,
   input  wire           data_valid_ns_i,
   input  wire           data_valid_i,
   input  wire   [31:0]  data_rdata_i,
@@ -24,6 +28,8 @@ module NanoCore_Wrapper#(
   output wire           instr_req_o,
   output wire   [ 1:0]  instr_req_2b_o, //* behind instr_req_o
   output wire   [31:0]  instr_addr_o,
+  output wire           instr_prefetch_req_o,
+  output wire   [31:0]  instr_prefetch_addr_o,
   input  wire   [ 1:0]  instr_valid_i,
   input  wire   [63:0]  instr_rdata_i,
 
@@ -39,38 +45,50 @@ module NanoCore_Wrapper#(
   output wire           o_irq_ack,
   output wire   [ 4:0]  o_irq_id,
   input  wire   [31:0]  i_irq_bitmap
-
+`ifdef ENABLE_HPM
+  ,
+  input  wire           i_miss_instr,
+  input  wire           i_miss_data,
+  output wire   [(`HPM_NUM+2)*64-1:0] o_hpm_cnt
+`endif
 );
 
   //====================================================================//
   //*   internal reg/wire/param declarations
   //====================================================================//
   wire        instr_req;
-  wire        data_req, data_we;
+  wire        data_req, data_we, data_amo;
   wire        data_ready;
   wire [31:0] instr_addr, data_addr;
   reg  [31:0] r_instr_addr_delay, r_data_addr_delay;
   wire [31:0] data_rdata;
   wire        w_mem_req, w_peri_req;
+  wire        w_data_gnt;
   reg         peri_ready_delay;
   reg  [31:0] peri_rdata_delay;
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
+  //* mmio fence: a peri access waits until buffered stores are drained;
+  assign data_fence_o = data_req & (data_addr[31:28] != 4'b0) & ~data_wcb_empty_i;
+  assign w_data_gnt   = data_gnt_i & ~data_fence_o;
+
   assign w_mem_req    = data_addr_o[31:28] == 4'b0 && data_req;
   assign w_peri_req   = data_addr_o[31:28] != 4'b0 && data_req;
   always_ff @(posedge i_clk) begin
-    r_data_addr_delay   <= (data_req & data_gnt_i)? data_addr: r_data_addr_delay;
+    r_data_addr_delay   <= (data_req & w_data_gnt)? data_addr: r_data_addr_delay;
     r_instr_addr_delay  <= (instr_req & instr_gnt_i)? instr_addr: r_instr_addr_delay;
   end
 
   assign instr_req_o  = instr_req & instr_gnt_i;
   assign instr_addr_o = instr_gnt_i? instr_addr: r_instr_addr_delay;
-  assign data_req_o   = data_gnt_i & w_mem_req & ~data_we; 
-  assign data_we_o    = data_gnt_i & w_mem_req & data_we; 
-  assign data_addr_o  = data_gnt_i? data_addr: r_data_addr_delay;
+  assign data_req_o   = w_data_gnt & w_mem_req & ~data_we; 
+  assign data_we_o    = w_data_gnt & w_mem_req & data_we; 
+  assign data_addr_o  = w_data_gnt? data_addr: r_data_addr_delay;
+  //* atomic to peri is sent as a normal read/write;
+  assign data_amo_o   = w_data_gnt & w_mem_req & data_amo;
 
-  assign o_peri_rden  = data_gnt_i & w_peri_req & ~data_we;
-  assign o_peri_wren  = data_gnt_i & w_peri_req & data_we;
+  assign o_peri_rden  = w_data_gnt & w_peri_req & ~data_we;
+  assign o_peri_wren  = w_data_gnt & w_peri_req & data_we;
   assign o_peri_addr  = data_addr_o;
   assign o_peri_wdata = data_wdata_o;
   assign o_peri_wstrb = data_wstrb_o;
@@ -101,12 +119,14 @@ module NanoCore_Wrapper#(
     .flush_o          (flush_o        ),
     .trap             (               ),
 
-    .data_gnt_i       (data_gnt_i     ),
+    .data_gnt_i       (w_data_gnt     ),
     .data_req_o       (data_req       ),
     .data_we_o        (data_we        ),
     .data_addr_o      (data_addr      ),
     .data_wstrb_o     (data_wstrb_o   ),
     .data_wdata_o     (data_wdata_o   ),
+    .data_amo_o       (data_amo       ),
+    .data_amo_op_o    (data_amo_op_o  ),
     .data_ready_ns_i  (data_valid_ns_i),
     .data_ready_i     (data_ready     ),
     .data_rdata_i     (data_rdata     ),
@@ -114,12 +134,20 @@ module NanoCore_Wrapper#(
     .instr_req_o      (instr_req      ),
     .instr_req_2b_o   (instr_req_2b_o ),
     .instr_addr_o     (instr_addr     ),
+    .instr_prefetch_req_o (instr_prefetch_req_o ),
+    .instr_prefetch_addr_o(instr_prefetch_addr_o),
     .instr_ready_i    (instr_valid_i  ),
     .instr_rdata_i    (instr_rdata_i  ),
 
     .i_irq            (i_irq_bitmap   ),
     .o_irq_ack        (o_irq_ack      ),
     .o_irq_id         (o_irq_id       )
+  `ifdef ENABLE_HPM
+    ,
+    .instr_miss_i     (i_miss_instr   ),
+    .data_miss_i      (i_miss_data    ),
+    .hpm_cnt_o        (o_hpm_cnt      )
+  `endif
   );
 
 endmodule
\ No newline at end of file
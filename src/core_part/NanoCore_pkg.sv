@@ -11,6 +11,25 @@ package NanoCore_pkg;
   localparam HEAD_WIDTH       = 512;  //* extract fields from pkt/meta head
   localparam integer regfile_size   = 32;
   localparam integer regindex_bits  = 5;
+  localparam integer bht_index_bits = 8;    //* 256 2-bit counters in bht
+  localparam integer ras_index_bits = 3;    //* 8-entry return address stack
+  localparam integer mbtb_way_bits  = 2;    //* mBTB is up to 4-way
+  //* hpm event id, written to mhpmevent3~ ('0' is off);
+  localparam integer HPM_EVT_BR_MISS  = 1;  //* branch/jalr mispredict, redirected by exec
+  localparam integer HPM_EVT_JAL_MISS = 2;  //* jal/backward branch missed in btb, redirected at d1
+  localparam integer HPM_EVT_IC_MISS  = 3;  //* icache miss (prefetch is not counted)
+  localparam integer HPM_EVT_DC_MISS  = 4;  //* dcache read miss
+  localparam integer HPM_EVT_LSQ_FULL = 5;  //* clks lsq is full (lsu_stall_idu)
+  localparam integer HPM_EVT_MU_BUSY  = 6;  //* clks mul/div is in flight
+  localparam integer HPM_EVT_ISSUE0   = 7;  //* clks no instr is issued
+  localparam integer HPM_EVT_ISSUE1   = 8;  //* clks only instr0 is issued
+  localparam integer HPM_EVT_ISSUE2   = 9;  //* clks instr0 & instr1 are issued
+  localparam integer HPM_EVT_IRQ      = 10; //* irq taken
+  localparam integer HPM_EVT_IRQ_CLK  = 11; //* clks from irq taken to retirq (in handler)
+  localparam integer hpm_evt_num      = 12;
+  //* funct5 of RV32A (amo_op), the same code is sent to memory;
+  localparam logic [4:0] AMO_LR       = 5'b00010;
+  localparam logic [4:0] AMO_SC       = 5'b00011;
 
   //==============================================================//
   // conguration according user defination, DO NOT NEED TO MODIFY!!!
@@ -115,6 +134,52 @@ package NanoCore_pkg;
     logic is_alu_reg_reg;
     logic is_compare;
     logic is_rdcycle_rdcycleh_rdinstr_rdinstrh;
+    logic is_rvc;       //* expanded from a 16b instr, next pc is pc+2
+    //* Zba/Zbb, executed by ex0/ex1;
+    logic instr_sh1add;
+    logic instr_sh2add;
+    logic instr_sh3add;
+    logic instr_andn;
+    logic instr_orn;
+    logic instr_xnor;
+    logic instr_clz;
+    logic instr_ctz;
+    logic instr_cpop;
+    logic instr_min;
+    logic instr_minu;
+    logic instr_max;
+    logic instr_maxu;
+    logic instr_rol;
+    logic instr_ror;    //* ror & rori
+    logic instr_sext_b;
+    logic instr_sext_h;
+    logic instr_zext_h;
+    logic instr_rev8;
+    logic instr_orc_b;
+    logic is_zb;
+    logic is_zb_imm;    //* rori & unary ops, alu_op2 is decoded_rs2 (shamt)
+    //* Zbc, executed by mu (as mul, i.e., instr_any_mul is set);
+    logic instr_clmul;
+    logic instr_clmulh;
+    logic instr_clmulr;
+    logic is_ld_idx;    //* fused add+load, addr is rs1+rs2+imm
+    //* Zihpm csr access, only issued as instr0 & executed at d1 (as maskirq);
+    logic instr_csrrw;
+    logic instr_csrrs;
+    logic instr_csrrc;
+    logic is_csr_hpm;
+    //* custom ones-complement checksum (custom-0), executed by ex0/ex1;
+    logic instr_csum_add;   //* rd = rs1 + rs2 with end-around carry
+    logic instr_csum_fold;  //* rd = 32b sum in rs1 folded to 16b
+    logic is_csum;
+    //* hardware loop setup (custom-3), only issued as instr0 & executed at d1,
+    //*   then refetch from pc+4 (as retirq);
+    logic is_hwlp;
+    logic [2:0] hwlp_op;    //* funct3: starti/endi/count/counti/setup/setupi
+    logic hwlp_level;
+    //* RV32A, issued to lsu as a lw (rd is written), executed at memory side;
+    logic is_amo;
+    logic [4:0] amo_op;     //* funct5, lr/sc/amoswap/amoadd/...
     logic [31:0] waddr;
   } uop_ctl_t;
 
@@ -130,14 +195,18 @@ package NanoCore_pkg;
     logic temp_ready;
     logic [2:0] stage;
     logic [2:0] alu; //* {lsu,ex1,ex0}
+    logic late;      //* load parked in lsq, ready at writeback
   } scoreboard_t;
 
   typedef struct packed {
     logic         valid;
-    logic [15:0]  pc;
-    logic [15:0]  tgt;
-    logic         is_jarl;
-    // logic [1:0]   bht;
+    logic [31:0]  pc;       //* pc of the last halfword of branch (pc+2 for 32b instr)
+    logic [31:0]  tgt;
+    logic         is_ret;   //* jalr (rs1 is x1/x5), target is given by ras
+    logic         is_br;    //* conditional branch, direction is given by bht
+    logic         is_call;  //* jal/jalr (rd is x1/x5), push ras, after pop if is_ret
+    logic         hit_mbtb; //* hit mBTB at prefetch, update the same way
+    logic [mbtb_way_bits-1:0] way_mbtb;
   } btb_t;
 
   // typedef struct packed {
@@ -150,14 +219,49 @@ package NanoCore_pkg;
   //   logic         insert_btb;   //* update or insert;
   // } btb_update_t;
   typedef struct packed {
-    // logic         hit;
+    logic         hit;      //* hit nanoBTB/mBTB at prefetch (any branch in this word)
     // logic         sbp_hit;
     logic         jump;
-    logic [15:0]  tgt;
-    logic [15:0]  pc;
+    logic         jmp_half; //* predicted branch ends at the upper halfword
+    logic [31:0]  tgt;
+    logic [31:0]  pc;
+    logic [bht_index_bits-1:0] bht_idx;  //* bht entry used to predict, for training
+    logic         hit_mbtb;
+    logic [mbtb_way_bits-1:0]  way_mbtb;
+    logic [ras_index_bits-1:0] ras_ptr;  //* ras checkpoint before this instr
+    logic [31:0]  ras_top;
+    logic [1:0][31:0] lp_cnt;  //* hwloop count checkpoint before this word
+    logic         br_hit;   //* ghr is shifted by the conditional branch ending at br_half
+    logic         br_half;
     // logic [3:0]   entryID;
   } btb_ctl_t;
 
+  //* bht training, sent by exec for each conditional branch;
+  typedef struct packed {
+    logic         inc_bht;  //* '1' is taken
+    logic [bht_index_bits-1:0] bht_idx;
+    logic         ghr_shift;//* counted by ghr at prefetch (btb_ctl.br_hit)
+  } bht_upd_t;
+
+  //* ras repair, sent with flush by the instr which causes flush;
+  typedef struct packed {
+    logic         push;     //* call, push ret_pc
+    logic         pop;      //* ret
+    logic [ras_index_bits-1:0] ras_ptr;
+    logic [31:0]  ras_top;
+    logic [31:0]  ret_pc;
+    logic [1:0][31:0] lp_cnt;  //* hwloop count, recovered with ras
+  } ras_fix_t;
+
+  //* hwloop start/end, sent by lp.* with flush (d2);
+  typedef struct packed {
+    logic         level;
+    logic         set_start;
+    logic         set_end;
+    logic [31:0]  start;
+    logic [31:0]  last;     //* pc of the last halfword of loop body, i.e., end-2
+  } lp_upd_t;
+
   // //* sbp;
   // typedef struct packed {
   //   logic         valid;
@@ -178,6 +282,8 @@ package NanoCore_pkg;
     logic         is_lu;
     logic         is_lh;
     logic         is_lb;
+    logic         is_amo;   //* lr/amo* is sent as a read, sc as a write
+    logic [4:0]   amo_op;
     logic [regindex_bits-1:0] rf_dst;
     logic [7:0]   uid;
   } lsu_ctl_t;
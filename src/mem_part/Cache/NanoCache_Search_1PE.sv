@@ -9,12 +9,29 @@
  *
  *  Noted:
  *      1) cache for instruction
+ *      2) PREFETCH: read the line of i_pref_addr while mm port is idle,
+ *          the line is filled without returning rvalid; a miss to the line
+ *          being prefetched waits for it (gnt is held low), instead of
+ *          reading it again;
+ *      3) RV32A for data (BYPASS), requester sends lr/sc/amo alone (no older
+ *          access in flight): lr is a read that sets the reservation (line)
+ *          of i_cache_rsv_id; sc is a write with wstrb masked to '0 if the
+ *          reservation is lost, rdata is 0/1 (done/fail); amo reads the old
+ *          value (returned as rdata), then writes back the result with gnt
+ *          held low; any write to the line (incl. snoop, i.e., dma) clears
+ *          the reservations;
+ *      4) instr miss returns rvalid in the clk of i_upd_valid (early restart),
+ *          data (BYPASS) keeps the registered rvalid, i.e., fixed latency;
+ *      5) snoop (dma write) invalidates the cached lines, incl. the line
+ *          being read, i.e., data can be cached without software flush;
  */
 
 module NanoCache_Search #(
   parameter DATA_WIDTH = 32,
   parameter RDEN_WIDTH = 1,
-  parameter BYPASS     = 1
+  parameter BYPASS     = 1,
+  parameter PREFETCH   = 0,
+  parameter NUM_RSV    = 1        //* num of lr reservations, one per requester
 ) (
   //* clk & reset;
   input   wire                        i_clk,
@@ -28,18 +45,28 @@ module NanoCache_Search #(
   input   wire  [31:0]                i_cache_addr,
   input   wire  [31:0]                i_cache_wdata,
   input   wire  [ 3:0]                i_cache_wstrb,
+  input   wire                        i_cache_amo,      //* lr/amo with rden, sc with wren
+  input   wire  [ 4:0]                i_cache_amo_op,   //* funct5 of RV32A
+  input   wire  [ 1:0]                i_cache_rsv_id,
+  input   wire                        i_snoop_wren,     //* line written by others
+  input   wire  [31:0]                i_snoop_addr,
+  input   wire                        i_snoop_inc,      //* the next line is written too
   output  wire  [DATA_WIDTH-1:0]      o_cache_rdata,
-  output  reg   [RDEN_WIDTH-1:0]      o_cache_rvalid,
+  output  wire  [RDEN_WIDTH-1:0]      o_cache_rvalid,
   output  reg                         o_cache_gnt,
+  input   wire                        i_pref_req,
+  input   wire  [31:0]                i_pref_addr,
 
   //* interface for reading SRAM by cache;
   output  wire                        o_miss_rden,
   output  wire                        o_miss_wren,
   output  wire  [31:0]                o_miss_addr,
+  output  wire                        o_miss_pref,
   output  wire  [7:0][31:0]           o_miss_wdata,
   output  logic [7:0][ 3:0]           o_miss_wstrb,
   input   wire                        i_miss_resp,
   input   wire                        i_upd_valid,
+  input   wire                        i_upd_pref,
   input   wire  [7:0][31:0]           i_upd_rdata,
   input   wire                        i_wr_finish
 );
@@ -55,33 +82,125 @@ module NanoCache_Search #(
   reg   [RDEN_WIDTH-1:0]              q_cache_rden;
   reg                                 q_cache_req;
   reg   [63:0]                        r_cache_rdata;
+  reg   [RDEN_WIDTH-1:0]              r_cache_rvalid;
+  wire                                w_upd_early;
+  logic [`NUM_CACHE-1:0]              w_pref_hit;
+  logic                               w_miss_rden, w_pref_rden;
+  reg                                 r_pref_wait;
+  reg   [15:0]                        r_pref_tag;
+  //* miss meets the prefetched line, being filled (fill) or in flight (merge);
+  wire                                w_pref_fill, w_pref_merge;
+  reg                                 r_pref_merge;
+  //* refill of the demand miss, i.e., a read miss or a merged prefetch;
+  wire                                w_upd_dem;
+  //* snoop, dma writes invalidate lines;
+  logic [`NUM_CACHE-1:0]              w_snoop_line;
+  wire                                w_snoop_req, w_snoop_q;
+  reg                                 r_fill_stale;     //* line being read is written by dma
+  //* atomic;
+  reg   [NUM_RSV-1:0]                 r_rsv_v;
+  reg   [NUM_RSV-1:0][26:0]           r_rsv_line;
+  reg                                 q_cache_amo;
+  reg   [ 4:0]                        q_amo_op;
+  reg   [31:0]                        q_cache_wdata;
+  reg                                 r_amo_wb;         //* write back amo result
+  reg                                 r_amo_wr;         //* wait wr_finish of amo
+  reg   [31:0]                        r_amo_wdata;
+  reg                                 r_sc_wait, r_sc_fail;
+  logic                               w_sc, w_sc_ok, w_amo_rd, w_amo_upd, w_wr_data;
+  logic [31:0]                        w_amo_old;
+  logic [31:0]                        w_amo_new;
+  wire  [26:0]                        w_wr_line = r_amo_wb? q_cache_addr[31:5]: i_cache_addr[31:5];
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
   //====================================================================//
   //*   Combine input signals
   //====================================================================//
-  assign o_cache_rdata    = r_cache_rdata[DATA_WIDTH-1:0]; 
-  assign o_miss_wdata     = {8{i_cache_wdata}};
-  assign o_miss_addr      = {5'b0,i_cache_addr[31:5]};
-  assign o_miss_wren      = i_cache_wren;
-  assign o_miss_rden      = i_cache_rden & (w_hit == 0);
+  //* early restart: instr (not BYPASS) miss returns the pair in the clk the
+  //*   line arrives, while the line is filled in the background;
+  assign w_upd_dem        = i_upd_valid & (~i_upd_pref | r_pref_merge);
+  assign w_upd_early      = ~BYPASS & w_upd_dem & q_cache_req & ~i_flush;
+  assign o_cache_rvalid   = r_cache_rvalid | {RDEN_WIDTH{w_upd_early}} & q_cache_rden;
+  assign o_cache_rdata    = w_upd_early? ((&q_cache_addr[4:2])? {2{i_upd_rdata[7]}}:
+                              {i_upd_rdata[3'(q_cache_addr[2+:3]+3'd1)],i_upd_rdata[q_cache_addr[2+:3]]}):
+                              r_cache_rdata[DATA_WIDTH-1:0];
+  assign o_miss_wdata     = r_amo_wb? {8{r_amo_wdata}}: {8{i_cache_wdata}};
+  assign o_miss_addr      = r_amo_wb? {5'b0,q_cache_addr[31:5]}:
+                            w_pref_rden? {5'b0,i_pref_addr[31:5]}: {5'b0,i_cache_addr[31:5]};
+  assign o_miss_wren      = i_cache_wren | r_amo_wb;
+  assign o_miss_rden      = w_miss_rden | w_pref_rden;
+  assign o_miss_pref      = w_pref_rden;
+  assign w_miss_rden      = i_cache_rden & (w_hit == 0) & ~w_pref_fill & ~w_pref_merge;
+  //* req is held while gnt is low, i.e., it is new only with gnt;
+  assign w_pref_fill      = ~BYPASS & o_cache_gnt & i_upd_valid & i_upd_pref &
+                            (r_pref_tag == i_cache_addr[5+:16]);
+  assign w_pref_merge     = ~BYPASS & (r_pref_merge | r_pref_wait & ~(i_upd_valid & i_upd_pref) &
+                                                      (r_pref_tag == i_cache_addr[5+:16]));
+  //* prefetch only when no demand access is waiting for mm port;
+  assign w_pref_rden      = PREFETCH & i_pref_req & (w_pref_hit == 0) & o_cache_gnt &
+                            ~w_miss_rden & ~i_cache_wren & ~r_pref_wait & ~i_flush & ~r_amo_wb;
+
+  //* atomic, lr/sc/amo (not lr) at issue, and amo meets its old value;
+  assign w_sc             = i_cache_wren & i_cache_amo & (i_cache_amo_op == 5'b00011);
+  assign w_amo_rd         = i_cache_rden & i_cache_amo & (i_cache_amo_op != 5'b00010);
+  assign w_amo_upd        = i_upd_valid & ~i_upd_pref & q_cache_req & q_cache_amo & 
+                            (q_amo_op != 5'b00010);
+  //* data is written to memory, i.e., store, amo or sc done;
+  assign w_wr_data        = i_cache_wren & ~(w_sc & ~w_sc_ok) | r_amo_wb;
+  always_comb begin
+    w_sc_ok               = 1'b0;
+    for(integer i=0; i<NUM_RSV; i=i+1)
+      if(i == i_cache_rsv_id)
+        w_sc_ok           = r_rsv_v[i] & (r_rsv_line[i] == i_cache_addr[31:5]);
+  end
+  assign w_amo_old        = i_upd_rdata[q_cache_addr[2+:3]];
+  always_comb begin
+    case(q_amo_op)
+      5'b00001: w_amo_new = q_cache_wdata;                  //* amoswap
+      5'b00000: w_amo_new = w_amo_old + q_cache_wdata;      //* amoadd
+      5'b00100: w_amo_new = w_amo_old ^ q_cache_wdata;      //* amoxor
+      5'b01100: w_amo_new = w_amo_old & q_cache_wdata;      //* amoand
+      5'b01000: w_amo_new = w_amo_old | q_cache_wdata;      //* amoor
+      5'b10000: w_amo_new = ($signed(w_amo_old) < $signed(q_cache_wdata))? w_amo_old: q_cache_wdata;
+      5'b10100: w_amo_new = ($signed(w_amo_old) < $signed(q_cache_wdata))? q_cache_wdata: w_amo_old;
+      5'b11000: w_amo_new = (w_amo_old < q_cache_wdata)? w_amo_old: q_cache_wdata;
+      5'b11100: w_amo_new = (w_amo_old < q_cache_wdata)? q_cache_wdata: w_amo_old;
+      default:  w_amo_new = w_amo_old;
+    endcase
+  end
 
   always_comb begin
     for(integer i=0; i<`NUM_CACHE; i=i+1) begin
-      w_hit[i]            = r_tag_valid[i]==1'b1 & ~BYPASS &
+      w_hit[i]            = r_tag_valid[i]==1'b1 & ~BYPASS & ~i_cache_amo &
                             r_tag_addr[i] == i_cache_addr[5+:16];
+      w_pref_hit[i]       = r_tag_valid[i]==1'b1 & r_tag_addr[i] == i_pref_addr[5+:16];
     end
   end
   always_comb begin
     o_miss_wstrb          = '0;
     for(integer i=0; i<8; i=i+1) begin
-      if(i== i_cache_addr[2+:3])
-        o_miss_wstrb[i]   = i_cache_wstrb;
+      if(r_amo_wb) begin
+        if(i== q_cache_addr[2+:3])
+          o_miss_wstrb[i] = 4'hf;
+      end
+      else if(i== i_cache_addr[2+:3])
+        o_miss_wstrb[i]   = (w_sc & ~w_sc_ok)? 4'b0: i_cache_wstrb;
     end
   end
+  function automatic snoop_match(input [15:0] tag);
+    return i_snoop_wren & ((tag == i_snoop_addr[15:0]) |
+                           i_snoop_inc & (tag == 16'(i_snoop_addr[15:0] + 1)));
+  endfunction
+  always_comb begin
+    for(integer i=0; i<`NUM_CACHE; i=i+1)
+      w_snoop_line[i]     = r_tag_valid[i] & snoop_match(r_tag_addr[i]);
+  end
+  assign w_snoop_req      = snoop_match(i_cache_addr[5+:16]);
+  assign w_snoop_q        = snoop_match(q_cache_addr[5+:16]);
+
   logic [7:0][31:0] w_hit_data;
   always_comb begin
-    w_hit_data            = '0;
+    w_hit_data            = w_pref_fill? i_upd_rdata: '0;
     for(integer i=0; i<`NUM_CACHE; i=i+1) begin
       w_hit_data          = w_hit_data | {256{w_hit[i]}} & r_cached_data[i];
     end
@@ -89,41 +208,86 @@ module NanoCache_Search #(
 
   always_ff @(posedge i_clk or negedge i_rst_n) begin
     if (~i_rst_n) begin
-      o_cache_rvalid          <= '0;
+      r_cache_rvalid          <= '0;
       o_cache_gnt             <= 1'b1;
 
       r_tag_valid             <= '0;
       r_vic                   <= 1;
+      r_pref_wait             <= '0;
+      r_pref_merge            <= '0;
+
+      r_rsv_v                 <= '0;
+      r_amo_wb                <= '0;
+      r_amo_wr                <= '0;
+      r_sc_wait               <= '0;
+      r_fill_stale            <= '0;
     end else begin
       //* instr serach;
-      o_cache_rvalid          <= '0;
+      r_cache_rvalid          <= '0;
       if(i_cache_rden == 1'b1) begin
-        if(|w_hit) begin
-          o_cache_rvalid      <= i_cache_rden_v;
-          r_cache_rdata       <= i_cache_addr[2]? {2{w_hit_data[i_cache_addr[2+:3]]}}:
-                    {w_hit_data[i_cache_addr[2+:3]+1],w_hit_data[i_cache_addr[2+:3]]};
+        if(|w_hit | w_pref_fill) begin
+          r_cache_rvalid      <= i_cache_rden_v;
+          r_cache_rdata       <= (&i_cache_addr[4:2])? {2{w_hit_data[7]}}:
+                    {w_hit_data[3'(i_cache_addr[2+:3]+3'd1)],w_hit_data[i_cache_addr[2+:3]]};
         end
         else begin
-          o_cache_rvalid      <= '0;
+          r_cache_rvalid      <= '0;
           o_cache_gnt         <= 1'b0;
         end
       end
 
-      if(i_flush | BYPASS | i_upd_valid)
+      if(i_flush | BYPASS | w_upd_dem)
+        o_cache_gnt           <= 1'b1;
+      //* amo holds gnt from issue to writing back its result;
+      if(r_amo_wb)
         o_cache_gnt           <= 1'b1;
+      else if(w_amo_rd | q_cache_req & q_cache_amo & (q_amo_op != 5'b00010))
+        o_cache_gnt           <= 1'b0;
+
+      //* atomic
+      r_amo_wb                <= w_amo_upd;
+      if(w_amo_upd)
+        r_amo_wdata           <= w_amo_new;
+      if(r_amo_wb)
+        r_amo_wr              <= 1'b1;
+      if(w_sc) begin
+        r_sc_wait             <= 1'b1;
+        r_sc_fail             <= ~w_sc_ok;
+      end
+      //* reservation, set by lr, cleared by sc & writes to the line;
+      for(integer i=0; i<NUM_RSV; i=i+1) begin
+        if(i == i_cache_rsv_id && i_cache_rden && i_cache_amo && i_cache_amo_op == 5'b00010) begin
+          r_rsv_v[i]          <= 1'b1;
+          r_rsv_line[i]       <= i_cache_addr[31:5];
+        end
+        if(i == i_cache_rsv_id && w_sc)
+          r_rsv_v[i]          <= 1'b0;
+        if(w_wr_data & (r_rsv_line[i] == w_wr_line) |
+           i_snoop_wren & (r_rsv_line[i] == i_snoop_addr[26:0]) |
+           i_snoop_wren & i_snoop_inc & (r_rsv_line[i] == 27'(i_snoop_addr[26:0] + 1)))
+          r_rsv_v[i]          <= 1'b0;
+      end
+
+      //* prefetch
+      r_pref_wait             <= w_pref_rden? 1'b1:
+                                 (i_flush | i_upd_valid & i_upd_pref)? 1'b0: r_pref_wait;
+      if(w_pref_rden)
+        r_pref_tag            <= i_pref_addr[5+:16];
+      r_pref_merge            <= (o_cache_gnt & i_cache_rden & w_pref_merge & ~(|w_hit))? 1'b1:
+                                 (i_flush | i_upd_valid)? 1'b0: r_pref_merge;
     
       //* meet flush
       if(i_flush & (i_cache_rden | ~o_cache_gnt & q_cache_req)) begin
-        o_cache_rvalid        <= i_cache_rden? i_cache_rden_v: q_cache_rden;
+        r_cache_rvalid        <= i_cache_rden? i_cache_rden_v: q_cache_rden;
       end
 
       //* update
-      if(i_upd_valid & q_cache_req & ~i_flush) begin
+      if(w_upd_dem & q_cache_req & ~i_flush) begin
         // r_tag_addr          <= r_temp_addr; TODO,
         r_vic                 <= {r_vic[`NUM_CACHE-2:0],r_vic[`NUM_CACHE-1]};
-        o_cache_rvalid        <= q_cache_rden;
-        r_cache_rdata         <= q_cache_addr[2]? {2{i_upd_rdata[q_cache_addr[2+:3]]}}:
-                                  {i_upd_rdata[q_cache_addr[2+:3]+1],i_upd_rdata[q_cache_addr[2+:3]]};
+        r_cache_rvalid        <= BYPASS? q_cache_rden: '0;
+        r_cache_rdata         <= (&q_cache_addr[4:2])? {2{i_upd_rdata[7]}}:
+                                  {i_upd_rdata[3'(q_cache_addr[2+:3]+3'd1)],i_upd_rdata[q_cache_addr[2+:3]]};
         for(integer i=0; i<`NUM_CACHE; i=i+1) begin
           if(r_vic[i] == 1'b1) begin
             r_cached_data[i]  <= i_upd_rdata;
@@ -132,16 +296,42 @@ module NanoCache_Search #(
           end
         end
       end
+      else if(i_upd_valid & i_upd_pref) begin
+        r_vic                 <= {r_vic[`NUM_CACHE-2:0],r_vic[`NUM_CACHE-1]};
+        for(integer i=0; i<`NUM_CACHE; i=i+1) begin
+          if(r_vic[i] == 1'b1) begin
+            r_cached_data[i]  <= i_upd_rdata;
+            r_tag_valid[i]    <= 1'b1;
+            r_tag_addr[i]     <= r_pref_tag;
+          end
+        end
+      end
       else if(i_wr_finish) begin
-        o_cache_rvalid        <= 1'b1;
+        //* no rvalid for the write back of amo;
+        r_cache_rvalid        <= ~r_amo_wr;
+        r_amo_wr              <= 1'b0;
+        r_sc_wait             <= 1'b0;
+        if(r_sc_wait)
+          r_cache_rdata       <= {63'b0, r_sc_fail};
       end
+
+      //* snoop: dma writes invalidate the lines, and the line being read
+      //*   (written by dma after read) is not kept;
+      r_fill_stale            <= o_cache_gnt? w_snoop_req: (r_fill_stale | w_snoop_q);
+      for(integer i=0; i<`NUM_CACHE; i=i+1)
+        if(w_snoop_line[i] | r_vic[i] & (r_fill_stale | w_snoop_q) &
+            w_upd_dem & q_cache_req)
+          r_tag_valid[i]      <= 1'b0;
     end
   end
 
   always_ff @(posedge i_clk) begin
-    q_cache_req       <= i_upd_valid? '0: ~i_flush &  q_cache_req;
+    q_cache_req       <= w_upd_dem? '0: ~i_flush &  q_cache_req;
     if(o_cache_gnt) begin
       q_cache_addr    <= i_cache_addr;
+      q_cache_wdata   <= i_cache_wdata;
+      q_cache_amo     <= i_cache_amo;
+      q_amo_op        <= i_cache_amo_op;
       q_cache_rden    <= i_cache_rden_v | {RDEN_WIDTH{i_cache_wren}};
       q_cache_req     <= i_cache_rden;
     end
@@ -0,0 +1,474 @@
+/*
+ *  Project:            NanoCore -- a RISCV-32MC SoC.
+ *  Module name:        NanoCache_Search_SA.
+ *  Description:        set-associative cache of nano core (instr).
+ *  Last updated date:  2024.9.1.
+ *
+ *  Communicate with Junnan Li <lijunnan@nudt.edu.cn>.
+ *  Copyright (C) 2021-2024 NUDT.
+ *
+ *  Noted:
+ *      1) NUM_SET * NUM_WAY lines of 32B, tags & data are kept in srams
+ *          (1-clk read, write-first), replaced by tree pseudo-lru, an
+ *          invalid way first; ways held by mshrs (in flight) of the same
+ *          set are not replaced;
+ *      2) lookup takes 2 stages: s0 reads srams, s1 compares tags and
+ *          returns rvalid (the same clk as NanoCache_Search) on hit;
+ *      3) non-blocking: each line in flight owns a mshr, a miss to the line
+ *          in flight is merged into its mshr; requests after a miss are
+ *          still looked up, and kept in resp queue (NUM_RESP) until the
+ *          older ones return, i.e., rvalid is returned in order;
+ *      4) mshrs are allocated & released in order, as NanoCache_Update
+ *          returns lines in order; a miss meeting full mshrs waits in resp
+ *          queue, and reads the line when a mshr is released;
+ *      5) i_flush is not used, i.e., a refill is always finished (and
+ *          kept), rvalid is returned for each granted request;
+ *      6) PREFETCH: probe tags of i_pref_addr by another tag sram, and read
+ *          the line with a free mshr while mm port is idle;
+ *      7) tags & plru are cleared in NUM_SET clks after reset, gnt is '0;
+ */
+
+module NanoCache_Search_SA #(
+  parameter DATA_WIDTH = 64,
+  parameter RDEN_WIDTH = 2,
+  parameter PREFETCH   = 0,
+  parameter NUM_SET    = 64,      //* 2^n
+  parameter NUM_WAY    = 4,       //* 2^n, >= 2
+  parameter NUM_MSHR   = 2,       //* 2^n, >= 2
+  parameter NUM_RESP   = 4        //* 2^n, >= 2
+) (
+  //* clk & reset;
+  input   wire                        i_clk,
+  input   wire                        i_rst_n,
+  input   wire                        i_flush,
+
+  //* interface for PEs;
+  input   wire                        i_cache_rden,
+  input   wire  [RDEN_WIDTH-1:0]      i_cache_rden_v,
+  input   wire  [31:0]                i_cache_addr,
+  output  wire  [DATA_WIDTH-1:0]      o_cache_rdata,
+  output  wire  [RDEN_WIDTH-1:0]      o_cache_rvalid,
+  output  reg                         o_cache_gnt,
+  input   wire                        i_pref_req,
+  input   wire  [31:0]                i_pref_addr,
+
+  //* interface for reading SRAM by cache;
+  output  wire                        o_miss_rden,
+  output  wire  [31:0]                o_miss_addr,
+  output  wire                        o_miss_pref,
+  input   wire                        i_miss_resp,
+  input   wire                        i_upd_valid,
+  input   wire                        i_upd_pref,
+  input   wire  [7:0][31:0]           i_upd_rdata
+);
+  //====================================================================//
+  //*   internal reg/wire/param declarations
+  //====================================================================//
+  localparam SET_BITS   = $clog2(NUM_SET);
+  localparam TAG_BITS   = 27 - SET_BITS;
+  localparam WAY_BITS   = $clog2(NUM_WAY);
+  localparam MSHR_BITS  = $clog2(NUM_MSHR);
+  localparam RESP_BITS  = $clog2(NUM_RESP);
+
+  //* s0/s1;
+  wire                                w_s0_v = i_cache_rden & o_cache_gnt;
+  reg                                 r_s1_v;
+  reg   [31:0]                        r_s1_addr;
+  reg   [RDEN_WIDTH-1:0]              r_s1_rden_v;
+  wire  [SET_BITS-1:0]                w_s1_set = r_s1_addr[5+:SET_BITS];
+  //* tags & data, tag is {valid, tag};
+  wire  [NUM_WAY-1:0][TAG_BITS:0]     w_tag_q, w_pref_tag_q;
+  wire  [NUM_WAY-1:0][7:0][31:0]      w_data_q;
+  logic [NUM_WAY-1:0]                 w_tag_q_v, w_pref_tag_q_v;
+  logic                               w_fill;
+  logic [SET_BITS-1:0]                w_fill_set;
+  logic [NUM_WAY-1:0]                 w_fill_way;
+  logic [TAG_BITS:0]                  w_fill_tag;
+  //* plru, NUM_WAY-1 bits per set (tree, the bit points to the victim);
+  reg   [NUM_WAY-2:0]                 r_plru[NUM_SET-1:0];
+  //* lookup;
+  logic [NUM_WAY-1:0]                 w_hit;
+  logic [WAY_BITS-1:0]                w_hit_way, w_vic_way, w_new_vic;
+  logic                               w_vic_ok, w_new_vic_ok, w_pref_vic_ok;
+  //* ways held by mshrs, of s1/new resp/probe set;
+  logic [NUM_WAY-1:0]                 w_s1_busy, w_new_busy, w_pref_busy;
+  logic [7:0][31:0]                   w_hit_line;
+  wire                                w_s1_hit, w_s1_upd, w_s1_rdy;
+  logic                               w_s1_mshr_hit;
+  logic [MSHR_BITS-1:0]               w_s1_mshr_id;
+  wire                                w_s1_alloc, w_s1_new;
+  //* mshr, released in order of allocation;
+  reg   [NUM_MSHR-1:0]                r_mshr_v;
+  reg   [NUM_MSHR-1:0][26:0]          r_mshr_line;
+  reg   [NUM_MSHR-1:0][WAY_BITS-1:0]  r_mshr_way;
+  reg   [MSHR_BITS-1:0]               r_mshr_wr, r_mshr_rd;
+  wire                                w_mshr_full = r_mshr_v[r_mshr_wr];
+  wire  [26:0]                        w_upd_line  = r_mshr_line[r_mshr_rd];
+  wire  [WAY_BITS-1:0]                w_upd_way   = r_mshr_way[r_mshr_rd];
+  logic [26:0]                        w_alloc_line;
+  logic [WAY_BITS-1:0]                w_alloc_way;
+  //* resp queue, in order of requests, new: waits for a free mshr;
+  reg   [NUM_RESP-1:0]                r_resp_v, r_resp_rdy, r_resp_new;
+  reg   [NUM_RESP-1:0][MSHR_BITS-1:0] r_resp_mshr;
+  reg   [NUM_RESP-1:0][31:0]          r_resp_addr;
+  reg   [NUM_RESP-1:0][RDEN_WIDTH-1:0]r_resp_rden_v;
+  reg   [NUM_RESP-1:0][63:0]          r_resp_data;
+  reg   [RESP_BITS-1:0]               r_resp_wr, r_resp_rd;
+  reg   [RESP_BITS:0]                 r_resp_cnt;
+  logic [NUM_RESP-1:0]                w_resp_upd;
+  logic [RESP_BITS:0]                 w_resp_cnt;
+  wire                                w_bypass, w_enq, w_deq;
+  //* the oldest-indexed new resp;
+  logic                               w_new_v, w_new_mshr_hit;
+  logic [RESP_BITS-1:0]               w_new_id;
+  logic [MSHR_BITS-1:0]               w_new_mshr_id;
+  wire  [26:0]                        w_new_line = r_resp_addr[w_new_id][31:5];
+  wire                                w_new_merge, w_new_alloc;
+  //* prefetch;
+  reg                                 r_probe_v;
+  reg   [31:0]                        r_probe_addr;
+  logic                               w_pref_hit, w_pref_rden;
+  logic [WAY_BITS-1:0]                w_pref_vic;
+  //* init;
+  reg                                 r_init;
+  reg   [SET_BITS-1:0]                r_init_set;
+  logic [63:0]                        w_rdata;
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  //====================================================================//
+  //*   functions
+  //====================================================================//
+  function automatic [WAY_BITS-1:0] plru_victim(input [NUM_WAY-2:0] t);
+    integer n;
+    n = 0;
+    for(integer l=0; l<WAY_BITS; l=l+1)
+      n = 2*n + 1 + t[n];
+    return WAY_BITS'(n - (NUM_WAY-1));
+  endfunction
+  function automatic [NUM_WAY-2:0] plru_touch(input [NUM_WAY-2:0] t,
+                                              input [WAY_BITS-1:0] w);
+    integer n;
+    plru_touch = t;
+    n = 0;
+    for(integer l=WAY_BITS-1; l>=0; l=l-1) begin
+      plru_touch[n] = ~w[l];
+      n = 2*n + 1 + w[l];
+    end
+  endfunction
+  //* an invalid way first, then plru victim, skip ways in flight ({ok,way});
+  function automatic [WAY_BITS:0] pick_way(input [NUM_WAY-1:0] vld,
+                                            input [NUM_WAY-1:0] busy,
+                                            input [NUM_WAY-2:0] t);
+    pick_way = {~busy[plru_victim(t)], plru_victim(t)};
+    if(busy[plru_victim(t)])
+      for(integer w=NUM_WAY-1; w>=0; w=w-1)
+        if(~busy[w])
+          pick_way = {1'b1, WAY_BITS'(w)};
+    for(integer w=NUM_WAY-1; w>=0; w=w-1)
+      if(~vld[w] & ~busy[w])
+        pick_way = {1'b1, WAY_BITS'(w)};
+  endfunction
+  //* two sequential words, only one at the last word of a line;
+  function automatic [63:0] line_pair(input [7:0][31:0] line, input [2:0] n);
+    return (&n)? {2{line[7]}}: {line[3'(n+3'd1)], line[n]};
+  endfunction
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  //====================================================================//
+  //*   s0: read tags & data
+  //====================================================================//
+  //* refill, or clear tags after reset;
+  always_comb begin
+    w_fill            = r_init | i_upd_valid;
+    w_fill_set        = r_init? r_init_set: w_upd_line[0+:SET_BITS];
+    w_fill_tag        = r_init? '0: {1'b1, w_upd_line[26-:TAG_BITS]};
+    for(integer w=0; w<NUM_WAY; w=w+1)
+      w_fill_way[w]   = r_init | (w == w_upd_way);
+  end
+
+  genvar gw;
+  generate
+    for(gw=0; gw<NUM_WAY; gw=gw+1) begin: gen_way
+      NanoCache_SA_ram #(
+        .WIDTH    (TAG_BITS+1             ),
+        .DEPTH    (NUM_SET                )
+      ) u_tag_ram (
+        .clk      (i_clk                  ),
+        .wren     (w_fill & w_fill_way[gw]),
+        .waddr    (w_fill_set             ),
+        .wdata    (w_fill_tag             ),
+        .raddr    (i_cache_addr[5+:SET_BITS]),
+        .rdata    (w_tag_q[gw]            )
+      );
+      NanoCache_SA_ram #(
+        .WIDTH    (256                    ),
+        .DEPTH    (NUM_SET                )
+      ) u_data_ram (
+        .clk      (i_clk                  ),
+        .wren     (~r_init & i_upd_valid & w_fill_way[gw]),
+        .waddr    (w_fill_set             ),
+        .wdata    (i_upd_rdata            ),
+        .raddr    (i_cache_addr[5+:SET_BITS]),
+        .rdata    (w_data_q[gw]           )
+      );
+      if(PREFETCH) begin: gen_pref
+        //* copy of tags, for probing the line of i_pref_addr;
+        NanoCache_SA_ram #(
+          .WIDTH  (TAG_BITS+1             ),
+          .DEPTH  (NUM_SET                )
+        ) u_pref_tag_ram (
+          .clk    (i_clk                  ),
+          .wren   (w_fill & w_fill_way[gw]),
+          .waddr  (w_fill_set             ),
+          .wdata  (w_fill_tag             ),
+          .raddr  (i_pref_addr[5+:SET_BITS]),
+          .rdata  (w_pref_tag_q[gw]       )
+        );
+      end
+      else begin: gen_no_pref
+        assign w_pref_tag_q[gw] = '0;
+      end
+    end
+  endgenerate
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  //====================================================================//
+  //*   s1: compare tags, merge into/allocate mshr
+  //====================================================================//
+  //* a way in flight is not refilled yet (its tag may still be invalid);
+  always_comb begin
+    for(integer w=0; w<NUM_WAY; w=w+1) begin
+      w_tag_q_v[w]      = w_tag_q[w][TAG_BITS];
+      w_pref_tag_q_v[w] = w_pref_tag_q[w][TAG_BITS];
+    end
+    w_s1_busy         = '0;
+    w_new_busy        = '0;
+    w_pref_busy       = '0;
+    for(integer m=0; m<NUM_MSHR; m=m+1) begin
+      if(r_mshr_v[m] & (r_mshr_line[m][0+:SET_BITS] == w_s1_set))
+        w_s1_busy[r_mshr_way[m]]    = 1'b1;
+      if(r_mshr_v[m] & (r_mshr_line[m][0+:SET_BITS] == w_new_line[0+:SET_BITS]))
+        w_new_busy[r_mshr_way[m]]   = 1'b1;
+      if(r_mshr_v[m] & (r_mshr_line[m][0+:SET_BITS] == r_probe_addr[5+:SET_BITS]))
+        w_pref_busy[r_mshr_way[m]]  = 1'b1;
+    end
+  end
+
+  always_comb begin
+    w_hit_line        = '0;
+    w_hit_way         = '0;
+    for(integer w=NUM_WAY-1; w>=0; w=w-1) begin
+      w_hit[w]        = w_tag_q[w][TAG_BITS] &
+                        (w_tag_q[w][TAG_BITS-1:0] == r_s1_addr[31-:TAG_BITS]);
+      w_hit_line      = w_hit_line | {256{w_hit[w]}} & w_data_q[w];
+      if(w_hit[w])
+        w_hit_way     = w;
+    end
+    {w_vic_ok, w_vic_way} = pick_way(w_tag_q_v, w_s1_busy, r_plru[w_s1_set]);
+    //* tags of new resp's set are not read, plru only;
+    {w_new_vic_ok, w_new_vic} = pick_way('1, w_new_busy, r_plru[w_new_line[0+:SET_BITS]]);
+  end
+  assign w_s1_hit     = r_s1_v & (|w_hit);
+  //* the line is refilled in this clk (its mshr is released);
+  assign w_s1_upd     = r_s1_v & i_upd_valid & (w_upd_line == r_s1_addr[31:5]);
+  assign w_s1_rdy     = w_s1_hit | w_s1_upd;
+  always_comb begin
+    w_s1_mshr_hit     = 1'b0;
+    w_s1_mshr_id      = '0;
+    w_new_mshr_hit    = 1'b0;
+    w_new_mshr_id     = '0;
+    for(integer m=0; m<NUM_MSHR; m=m+1) begin
+      if(r_mshr_v[m] & (r_mshr_line[m] == r_s1_addr[31:5])) begin
+        w_s1_mshr_hit = 1'b1;
+        w_s1_mshr_id  = m;
+      end
+      if(r_mshr_v[m] & (r_mshr_line[m] == w_new_line)) begin
+        w_new_mshr_hit= 1'b1;
+        w_new_mshr_id = m;
+      end
+    end
+  end
+  //* waits in resp queue if mshrs are full, or all ways of the set are in flight;
+  assign w_s1_alloc   = r_s1_v & ~w_s1_rdy & ~w_s1_mshr_hit & ~w_mshr_full & w_vic_ok;
+  assign w_s1_new     = r_s1_v & ~w_s1_rdy & ~w_s1_mshr_hit & ~w_s1_alloc;
+
+  //* new resp, merged into or allocates a mshr when the miss port is free;
+  always_comb begin
+    w_new_v           = 1'b0;
+    w_new_id          = '0;
+    for(integer i=NUM_RESP-1; i>=0; i=i-1)
+      if(r_resp_v[i] & r_resp_new[i]) begin
+        w_new_v       = 1'b1;
+        w_new_id      = i;
+      end
+  end
+  assign w_new_merge  = w_new_v & ~w_resp_upd[w_new_id] & w_new_mshr_hit;
+  assign w_new_alloc  = w_new_v & ~w_resp_upd[w_new_id] & ~w_new_mshr_hit &
+                        ~w_mshr_full & ~w_s1_alloc & w_new_vic_ok;
+
+  //* prefetch only when no demand access is waiting for mm port;
+  always_comb begin
+    w_pref_hit        = 1'b0;
+    for(integer w=NUM_WAY-1; w>=0; w=w-1)
+      w_pref_hit      = w_pref_hit | w_pref_tag_q[w][TAG_BITS] &
+                        (w_pref_tag_q[w][TAG_BITS-1:0] == r_probe_addr[31-:TAG_BITS]);
+    for(integer m=0; m<NUM_MSHR; m=m+1)
+      w_pref_hit      = w_pref_hit | r_mshr_v[m] & (r_mshr_line[m] == r_probe_addr[31:5]);
+    {w_pref_vic_ok, w_pref_vic} = pick_way(w_pref_tag_q_v, w_pref_busy,
+                                            r_plru[r_probe_addr[5+:SET_BITS]]);
+    w_pref_rden       = PREFETCH & r_probe_v & ~w_pref_hit & ~w_mshr_full & w_pref_vic_ok &
+                        ~w_s1_alloc & ~w_new_alloc & ~w_new_v;
+  end
+
+  //* miss port;
+  assign o_miss_rden  = w_s1_alloc | w_new_alloc | w_pref_rden;
+  assign o_miss_pref  = w_pref_rden;
+  assign o_miss_addr  = {5'b0, w_alloc_line};
+  always_comb begin
+    w_alloc_line      = w_s1_alloc? r_s1_addr[31:5]: w_new_alloc? w_new_line: r_probe_addr[31:5];
+    w_alloc_way       = w_s1_alloc? w_vic_way:
+                        w_new_alloc? w_new_vic: w_pref_vic;
+  end
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  //====================================================================//
+  //*   resp: bypass s1 if queue is empty, or return the head in order
+  //====================================================================//
+  always_comb begin
+    for(integer i=0; i<NUM_RESP; i=i+1)
+      w_resp_upd[i]   = i_upd_valid & r_resp_v[i] & ~r_resp_rdy[i] &
+                        (r_resp_new[i]? (r_resp_addr[i][31:5] == w_upd_line):
+                                        (r_resp_mshr[i] == r_mshr_rd));
+  end
+  assign w_bypass     = w_s1_rdy & (r_resp_cnt == 0);
+  assign w_enq        = r_s1_v & ~w_bypass;
+  assign w_deq        = r_resp_v[r_resp_rd] & (r_resp_rdy[r_resp_rd] | w_resp_upd[r_resp_rd]);
+  assign w_resp_cnt   = r_resp_cnt + w_enq - w_deq;
+
+  always_comb begin
+    if(w_bypass)
+      w_rdata         = w_s1_hit? line_pair(w_hit_line, r_s1_addr[2+:3]):
+                                  line_pair(i_upd_rdata, r_s1_addr[2+:3]);
+    else if(r_resp_rdy[r_resp_rd])
+      w_rdata         = r_resp_data[r_resp_rd];
+    else
+      w_rdata         = line_pair(i_upd_rdata, r_resp_addr[r_resp_rd][2+:3]);
+  end
+  assign o_cache_rdata  = w_rdata[DATA_WIDTH-1:0];
+  assign o_cache_rvalid = w_bypass? r_s1_rden_v:
+                          w_deq? r_resp_rden_v[r_resp_rd]: '0;
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  always_ff @(posedge i_clk or negedge i_rst_n) begin
+    if (~i_rst_n) begin
+      o_cache_gnt             <= 1'b0;
+      r_s1_v                  <= 1'b0;
+      r_mshr_v                <= '0;
+      r_mshr_wr               <= '0;
+      r_mshr_rd               <= '0;
+      r_resp_v                <= '0;
+      r_resp_wr               <= '0;
+      r_resp_rd               <= '0;
+      r_resp_cnt              <= '0;
+      r_probe_v               <= 1'b0;
+      r_init                  <= 1'b1;
+      r_init_set              <= '0;
+    end else begin
+      //* clear tags;
+      if(r_init) begin
+        r_init_set            <= r_init_set + 1;
+        if(&r_init_set)
+          r_init              <= 1'b0;
+      end
+
+      //* s0 -> s1, gnt if resp queue has room for s1 & the next one;
+      r_s1_v                  <= w_s0_v;
+      r_s1_addr               <= i_cache_addr;
+      r_s1_rden_v             <= i_cache_rden_v;
+      o_cache_gnt             <= ~r_init & (w_resp_cnt + w_s0_v + 1 <= NUM_RESP);
+
+      //* mshr, allocated by miss, released by refill;
+      if(o_miss_rden) begin
+        r_mshr_v[r_mshr_wr]   <= 1'b1;
+        r_mshr_line[r_mshr_wr]<= w_alloc_line;
+        r_mshr_way[r_mshr_wr] <= w_alloc_way;
+        r_mshr_wr             <= r_mshr_wr + 1;
+      end
+      if(i_upd_valid) begin
+        r_mshr_v[r_mshr_rd]   <= 1'b0;
+        r_mshr_rd             <= r_mshr_rd + 1;
+      end
+
+      //* resp queue;
+      r_resp_cnt              <= w_resp_cnt;
+      for(integer i=0; i<NUM_RESP; i=i+1)
+        if(w_resp_upd[i]) begin
+          r_resp_rdy[i]       <= 1'b1;
+          r_resp_new[i]       <= 1'b0;
+          r_resp_data[i]      <= line_pair(i_upd_rdata, r_resp_addr[i][2+:3]);
+        end
+      if(w_new_merge | w_new_alloc) begin
+        r_resp_new[w_new_id]  <= 1'b0;
+        r_resp_mshr[w_new_id] <= w_new_merge? w_new_mshr_id: r_mshr_wr;
+      end
+      if(w_deq) begin
+        r_resp_v[r_resp_rd]   <= 1'b0;
+        r_resp_rd             <= r_resp_rd + 1;
+      end
+      if(w_enq) begin
+        r_resp_v[r_resp_wr]   <= 1'b1;
+        r_resp_rdy[r_resp_wr] <= w_s1_rdy;
+        r_resp_new[r_resp_wr] <= w_s1_new;
+        r_resp_mshr[r_resp_wr]<= w_s1_mshr_hit? w_s1_mshr_id: r_mshr_wr;
+        r_resp_addr[r_resp_wr]<= r_s1_addr;
+        r_resp_rden_v[r_resp_wr]  <= r_s1_rden_v;
+        r_resp_data[r_resp_wr]    <= w_s1_hit? line_pair(w_hit_line, r_s1_addr[2+:3]):
+                                               line_pair(i_upd_rdata, r_s1_addr[2+:3]);
+        r_resp_wr             <= r_resp_wr + 1;
+      end
+
+      //* prefetch
+      r_probe_v               <= PREFETCH & i_pref_req & ~r_init;
+      r_probe_addr            <= i_pref_addr;
+    end
+  end
+
+  //* touch plru by hit or allocating a mshr, cleared with tags;
+  always_ff @(posedge i_clk) begin
+    if(r_init)
+      r_plru[r_init_set]      <= '0;
+    else begin
+      if(w_s1_hit)
+        r_plru[w_s1_set]      <= plru_touch(r_plru[w_s1_set], w_hit_way);
+      if(o_miss_rden)
+        r_plru[w_alloc_line[0+:SET_BITS]] <= plru_touch(
+                      (w_s1_hit & (w_s1_set == w_alloc_line[0+:SET_BITS]))?
+                      plru_touch(r_plru[w_s1_set], w_hit_way): r_plru[w_alloc_line[0+:SET_BITS]],
+                      w_alloc_way);
+    end
+  end
+
+endmodule
+
+//* simple dual-port ram (1W1R), write-first, 1-clk read latency;
+module NanoCache_SA_ram #(
+  parameter WIDTH = 32,
+  parameter DEPTH = 64
+) (
+  input                               clk,
+  input   wire                        wren,
+  input   wire  [$clog2(DEPTH)-1:0]   waddr,
+  input   wire  [WIDTH-1:0]           wdata,
+  input   wire  [$clog2(DEPTH)-1:0]   raddr,
+  output  reg   [WIDTH-1:0]           rdata
+);
+  (* ram_style = "block" *)
+  reg   [WIDTH-1:0]   mem[0:DEPTH-1];
+
+  always_ff @(posedge clk) begin
+    if(wren)
+      mem[waddr]      <= wdata;
+    rdata             <= (wren & (waddr == raddr))? wdata: mem[raddr];
+  end
+
+endmodule
@@ -6,6 +6,16 @@
 //  Noted:
 //    1) two 32b*8 cache lines, one for instr, another for data;
 //    2) adopt write-back;
+//    3) icache prefetches the next line when the mm port is idle;
+//    4) lr/sc/amo are executed in data search, with the reservation of lr;
+//    5) CACHE_SA: icache is set-associative in srams (NanoCache_Search_SA),
+//      non-blocking with mshrs; dcache is unchanged, as lsu expects a fixed
+//      2-clk latency;
+//    6) ENABLE_WCB: data writes are combined in lines (NanoCache_WCB) before
+//      update, and drained before mmio accesses (i_data_fence);
+//    7) dma (snoop) is coherent with data cache: its writes invalidate the
+//      cached lines and overwrite buffered bytes, its reads get buffered
+//      bytes (o_snoop_rdata), i.e., no flush is needed by software;
 /*************************************************************/
 
 
@@ -22,12 +32,26 @@ module NanoCache_Top (
   input   wire  [      31:0]  i_data_addr  ,
   input   wire  [       3:0]  i_data_wstrb ,
   input   wire  [      31:0]  i_data_wdata ,
+  input   wire                i_data_amo   ,
+  input   wire  [       4:0]  i_data_amo_op,
+  input   wire                i_snoop_wren ,  //* write by others (dma), line addr
+  input   wire  [      31:0]  i_snoop_addr ,
+  input   wire                i_snoop_inc  ,  //* the next line is written too
+  input   wire                i_snoop_rden ,  //* read by others (dma)
+  input   wire  [       7:0]  i_snoop_wstrb,  //* word strobe of dma write
+  input   wire  [       7:0]  i_snoop_winc ,  //* the word is in the next line
+  output  wire  [7:0][31:0]   o_snoop_rdata,  //* buffered bytes for dma read
+  output  wire  [7:0][ 3:0]   o_snoop_rstrb,
+  input   wire                i_data_fence ,  //* drain buffered writes (mmio)
+  output  wire                o_data_wcb_empty,
   output  wire                o_data_valid ,
   output  wire  [      31:0]  o_data_rdata ,
   output  wire                o_instr_gnt  ,
   input   wire                i_instr_req  ,
   input   wire  [       1:0]  i_instr_req_2b,
   input   wire  [      31:0]  i_instr_addr ,
+  input   wire                i_instr_prefetch_req,
+  input   wire  [      31:0]  i_instr_prefetch_addr,
   output  wire  [       1:0]  o_instr_valid,
   output  wire  [      63:0]  o_instr_rdata,
 
@@ -45,6 +69,12 @@ module NanoCache_Top (
   input   wire  [7:0][31:0]   i_mm_rdata_data,
   input   wire                i_mm_rvalid_data,
   input   wire                i_mm_gnt_data
+`ifdef ENABLE_HPM
+  //* demand miss (prefetch is not counted), for hpm;
+  ,
+  output  wire                o_miss_instr,
+  output  wire                o_miss_data
+`endif
 );
   //====================================================================//
   //*   internal reg/wire/param declarations
@@ -52,6 +82,7 @@ module NanoCache_Top (
   wire                  w_miss_rden_instr;
   wire  [31:0]          w_miss_addr_instr;
   wire  [7:0][31:0]     w_miss_wdata_instr;
+  wire                  w_miss_pref_instr, w_upd_pref_instr;
   wire                  w_miss_resp_instr, w_upd_valid_instr;
   wire  [7:0][31:0]     w_upd_rdata_instr;
   wire                  w_miss_rden_data, w_miss_wren_data;
@@ -61,14 +92,65 @@ module NanoCache_Top (
   wire                  w_miss_resp_data, w_upd_valid_data, w_wr_finish;
   wire  [7:0][31:0]     w_upd_rdata_data;
   wire                  w_wb_wren_data, w_wb_gnt_data;
+  wire                  w_wcb_rden, w_wcb_wren, w_wcb_upd_valid, w_wcb_wr_finish;
+  wire  [31:0]          w_wcb_addr;
+  wire  [7:0][31:0]     w_wcb_wdata, w_wcb_upd_rdata;
+  wire  [7:0][ 3:0]     w_wcb_wstrb;
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
+`ifdef ENABLE_HPM
+  assign o_miss_instr   = w_miss_rden_instr & ~w_miss_pref_instr;
+  assign o_miss_data    = w_miss_rden_data;
+`endif
+
+
+`ifdef CACHE_SA
+  NanoCache_Search_SA
+  #(
+    .DATA_WIDTH     (64                   ),
+    .RDEN_WIDTH     (2                    ),
+  `ifdef ENABLE_IPREFETCH
+    .PREFETCH       (1                    ),
+  `else
+    .PREFETCH       (0                    ),
+  `endif
+    .NUM_SET        (`CACHE_NUM_SET       ),
+    .NUM_WAY        (`CACHE_NUM_WAY       ),
+    .NUM_MSHR       (`CACHE_NUM_MSHR      ),
+    .NUM_RESP       (4                    )
+  ) cache_search_instr (
+    .i_clk          (i_clk                ),
+    .i_rst_n        (i_rst_n              ),
+    .i_flush        (i_flush              ),
+
+    .o_cache_gnt    (o_instr_gnt          ),
+    .i_cache_rden   (i_instr_req          ),
+    .i_cache_rden_v (i_instr_req_2b       ),
+    .i_cache_addr   (i_instr_addr         ),
+    .o_cache_rdata  (o_instr_rdata        ),
+    .o_cache_rvalid (o_instr_valid        ),
+    .i_pref_req     (i_instr_prefetch_req ),
+    .i_pref_addr    (i_instr_prefetch_addr),
 
+    .o_miss_rden    (w_miss_rden_instr    ),
+    .o_miss_addr    (w_miss_addr_instr    ),
+    .o_miss_pref    (w_miss_pref_instr    ),
+    .i_miss_resp    (w_miss_resp_instr    ),
+    .i_upd_valid    (w_upd_valid_instr    ),
+    .i_upd_pref     (w_upd_pref_instr     ),
+    .i_upd_rdata    (w_upd_rdata_instr    )
+  );
+`else
   NanoCache_Search 
   #(
     .DATA_WIDTH     (64                   ),
     .RDEN_WIDTH     (2                    ),
-    .BYPASS         (0                    )
+    .BYPASS         (0                    ),
+  `ifdef ENABLE_IPREFETCH
+    .PREFETCH       (1                    )
+  `else
+    .PREFETCH       (0                    )
+  `endif
   ) cache_search_instr (
     .i_clk          (i_clk                ),
     .i_rst_n        (i_rst_n              ),
@@ -81,30 +163,46 @@ module NanoCache_Top (
     .i_cache_wren   ('0                   ),
     .i_cache_wdata  ('0                   ),
     .i_cache_wstrb  ('0                   ),
+    .i_cache_amo    ('0                   ),
+    .i_cache_amo_op ('0                   ),
+    .i_cache_rsv_id ('0                   ),
+    .i_snoop_wren   ('0                   ),
+    .i_snoop_addr   ('0                   ),
+    .i_snoop_inc    ('0                   ),
     .o_cache_rdata  (o_instr_rdata        ),
     .o_cache_rvalid (o_instr_valid        ),
+    .i_pref_req     (i_instr_prefetch_req ),
+    .i_pref_addr    (i_instr_prefetch_addr),
 
     .o_miss_rden    (w_miss_rden_instr    ),
     .o_miss_wren    (                     ),
     .o_miss_addr    (w_miss_addr_instr    ),
+    .o_miss_pref    (w_miss_pref_instr    ),
     .o_miss_wdata   (                     ),
     .o_miss_wstrb   (                     ),
     .i_miss_resp    (w_miss_resp_instr    ),
     .i_upd_valid    (w_upd_valid_instr    ),
+    .i_upd_pref     (w_upd_pref_instr     ),
     .i_upd_rdata    (w_upd_rdata_instr    ),
     .i_wr_finish    ('0                   )
   );
+`endif
 
   NanoCache_Update #(
     .BUFFER         (0                    )
   ) cache_update_instr (
     .i_clk          (i_clk                ),
     .i_rst_n        (i_rst_n              ),
+  `ifdef CACHE_SA
+    .i_flush        ('0                   ),  //* refill is always kept
+  `else
     .i_flush        (i_flush              ),
+  `endif
 
     .i_miss_rden    (w_miss_rden_instr    ),
     .i_miss_wren    ('0                   ),
     .i_miss_addr    (w_miss_addr_instr    ),
+    .i_miss_pref    (w_miss_pref_instr    ),
     .i_miss_wdata   ('0                   ),
     .i_miss_wstrb   ('0                   ),
     .o_miss_resp    (w_miss_resp_instr    ),
@@ -119,11 +217,14 @@ module NanoCache_Top (
     .i_mm_rvalid    (i_mm_rvalid_instr    ),
 
     .o_upd_valid    (w_upd_valid_instr    ),
+    .o_upd_pref     (w_upd_pref_instr     ),
     .o_upd_rdata    (w_upd_rdata_instr    ),
     .o_wr_finish    (                     )
   );
 
-  NanoCache_Search cache_search_data (
+  NanoCache_Search #(
+    .NUM_RSV        (`NUM_PE              )
+  ) cache_search_data (
     .i_clk          (i_clk                ),
     .i_rst_n        (i_rst_n              ),
     .i_flush        ('0                   ),
@@ -135,20 +236,84 @@ module NanoCache_Top (
     .i_cache_wren   (i_data_we            ),
     .i_cache_wdata  (i_data_wdata         ),
     .i_cache_wstrb  (i_data_wstrb         ),
+    .i_cache_amo    (i_data_amo           ),
+    .i_cache_amo_op (i_data_amo_op        ),
+    .i_cache_rsv_id ('0                   ),  //* data port is not arbitrated per PE yet
+    .i_snoop_wren   (i_snoop_wren         ),
+    .i_snoop_addr   (i_snoop_addr         ),
+    .i_snoop_inc    (i_snoop_inc          ),
     .o_cache_rdata  (o_data_rdata         ),
     .o_cache_rvalid (o_data_valid         ),
+    .i_pref_req     ('0                   ),
+    .i_pref_addr    ('0                   ),
 
     .o_miss_rden    (w_miss_rden_data     ),
     .o_miss_wren    (w_miss_wren_data     ),
     .o_miss_addr    (w_miss_addr_data     ),
+    .o_miss_pref    (                     ),
     .o_miss_wdata   (w_miss_wdata_data    ),
     .o_miss_wstrb   (w_miss_wstrb_data    ),
     .i_miss_resp    (w_miss_resp_data     ),
     .i_upd_valid    (w_upd_valid_data     ),
+    .i_upd_pref     ('0                   ),
     .i_upd_rdata    (w_upd_rdata_data     ),
     .i_wr_finish    (w_wr_finish          )
   );
 
+`ifdef ENABLE_WCB
+  NanoCache_WCB #(
+  `ifdef DATA_SRAM_noBUFFER
+    .BUFFER         (0                    ),
+  `else
+    .BUFFER         (1                    ),
+  `endif
+    .NUM_WCB        (`NUM_WCB             )
+  ) cache_wcb_data (
+    .i_clk          (i_clk                ),
+    .i_rst_n        (i_rst_n              ),
+
+    .i_miss_rden    (w_miss_rden_data     ),
+    .i_miss_wren    (w_miss_wren_data     ),
+    .i_miss_addr    (w_miss_addr_data     ),
+    .i_miss_wdata   (w_miss_wdata_data    ),
+    .i_miss_wstrb   (w_miss_wstrb_data    ),
+    .o_upd_valid    (w_upd_valid_data     ),
+    .o_upd_rdata    (w_upd_rdata_data     ),
+    .o_wr_finish    (w_wr_finish          ),
+
+    .o_miss_rden    (w_wcb_rden           ),
+    .o_miss_wren    (w_wcb_wren           ),
+    .o_miss_addr    (w_wcb_addr           ),
+    .o_miss_wdata   (w_wcb_wdata          ),
+    .o_miss_wstrb   (w_wcb_wstrb          ),
+    .i_upd_valid    (w_wcb_upd_valid      ),
+    .i_upd_rdata    (w_wcb_upd_rdata      ),
+
+    .i_fence        (i_data_fence         ),
+    .o_empty        (o_data_wcb_empty     ),
+
+    .i_snoop_rden   (i_snoop_rden         ),
+    .i_snoop_wren   (i_snoop_wren         ),
+    .i_snoop_addr   (i_snoop_addr         ),
+    .i_snoop_wstrb  (i_snoop_wstrb        ),
+    .i_snoop_winc   (i_snoop_winc         ),
+    .o_snoop_rdata  (o_snoop_rdata        ),
+    .o_snoop_rstrb  (o_snoop_rstrb        )
+  );
+`else
+  assign w_wcb_rden       = w_miss_rden_data;
+  assign w_wcb_wren       = w_miss_wren_data;
+  assign w_wcb_addr       = w_miss_addr_data;
+  assign w_wcb_wdata      = w_miss_wdata_data;
+  assign w_wcb_wstrb      = w_miss_wstrb_data;
+  assign w_upd_valid_data = w_wcb_upd_valid;
+  assign w_upd_rdata_data = w_wcb_upd_rdata;
+  assign w_wr_finish      = w_wcb_wr_finish;
+  assign o_data_wcb_empty = 1'b1;
+  assign o_snoop_rdata    = '0;
+  assign o_snoop_rstrb    = '0;
+`endif
+
   NanoCache_Update 
 `ifdef DATA_SRAM_noBUFFER  
   #(  
@@ -160,11 +325,12 @@ module NanoCache_Top (
     .i_rst_n        (i_rst_n              ),
     .i_flush        ('0                   ),
 
-    .i_miss_rden    (w_miss_rden_data     ),
-    .i_miss_wren    (w_miss_wren_data     ),
-    .i_miss_addr    (w_miss_addr_data     ),
-    .i_miss_wdata   (w_miss_wdata_data    ),
-    .i_miss_wstrb   (w_miss_wstrb_data    ),
+    .i_miss_rden    (w_wcb_rden           ),
+    .i_miss_wren    (w_wcb_wren           ),
+    .i_miss_addr    (w_wcb_addr           ),
+    .i_miss_pref    ('0                   ),
+    .i_miss_wdata   (w_wcb_wdata          ),
+    .i_miss_wstrb   (w_wcb_wstrb          ),
     .o_miss_resp    (w_miss_resp_data     ),
 
     .o_mm_rden      (o_mm_rden_data       ),
@@ -176,9 +342,10 @@ module NanoCache_Top (
     .i_mm_rdata     (i_mm_rdata_data      ),
     .i_mm_rvalid    (i_mm_rvalid_data     ),
 
-    .o_upd_valid    (w_upd_valid_data     ),
-    .o_upd_rdata    (w_upd_rdata_data     ),
-    .o_wr_finish    (w_wr_finish          )
+    .o_upd_valid    (w_wcb_upd_valid      ),
+    .o_upd_pref     (                     ),
+    .o_upd_rdata    (w_wcb_upd_rdata      ),
+    .o_wr_finish    (w_wcb_wr_finish      )
   );
 
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
@@ -8,6 +8,10 @@
  *  Copyright (C) 2021-2024 NUDT.
  *
  *  Noted:
+ *      1) o_upd_pref marks the returned line as a prefetch;
+ *      2) mm reads a line from 8 word banks in parallel, i.e., the requested
+ *          word always arrives in the first (only) beat, and is forwarded by
+ *          search in the clk of o_upd_valid (early restart);
  */
 
 module NanoCache_Update #(
@@ -21,6 +25,7 @@ module NanoCache_Update #(
   input   wire               i_miss_rden,
   input   wire               i_miss_wren,
   input   wire  [31:0]       i_miss_addr,
+  input   wire               i_miss_pref,    //* read is a prefetch;
   input   wire  [7:0][31:0]  i_miss_wdata,
   input   wire  [7:0][ 3:0]  i_miss_wstrb,
   output  wire               o_miss_resp,
@@ -36,13 +41,14 @@ module NanoCache_Update #(
   input   wire                i_mm_rvalid,
 
   output  wire                o_upd_valid,
+  output  wire                o_upd_pref,
   output  wire  [7:0][31:0]   o_upd_rdata,
   output  wire                o_wr_finish
 );
   //====================================================================//
   //*   internal reg/wire/param declarations
   //====================================================================//
-  reg   [1:0]                 r_tag_read, r_tag_write;
+  reg   [1:0]                 r_tag_read, r_tag_write, r_tag_pref;
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
   //====================================================================//
@@ -50,6 +56,7 @@ module NanoCache_Update #(
   //====================================================================//
   assign o_miss_resp  = i_miss_rden | i_miss_wren;
   assign o_upd_valid  = BUFFER? r_tag_read[1]: r_tag_read[0];
+  assign o_upd_pref   = BUFFER? r_tag_pref[1]: r_tag_pref[0];
   assign o_wr_finish  = BUFFER? r_tag_write[1]: r_tag_write[0];
   assign o_upd_rdata  = i_mm_rdata;
   assign o_mm_wren    = i_miss_wren;
@@ -63,9 +70,12 @@ module NanoCache_Update #(
     if (~i_rst_n) begin
       r_tag_read                <= '0;
       r_tag_write               <= '0;
+      r_tag_pref                <= '0;
     end else begin
       r_tag_read[0]             <= i_miss_rden & ~i_flush;
       r_tag_read[1]             <= r_tag_read[0] & ~i_flush;
+      r_tag_pref[0]             <= i_miss_rden & i_miss_pref & ~i_flush;
+      r_tag_pref[1]             <= r_tag_pref[0] & ~i_flush;
       r_tag_write               <= {r_tag_write[0], i_miss_wren};
     end
   end
@@ -0,0 +1,217 @@
+/*
+ *  Project:            NanoCore -- a RISCV-32MC SoC.
+ *  Module name:        NanoCache_WCB.
+ *  Description:        write-combining buffer of data cache.
+ *  Last updated date:  2024.9.1.
+ *
+ *  Communicate with Junnan Li <lijunnan@nudt.edu.cn>.
+ *  Copyright (C) 2021-2024 NUDT.
+ *
+ *  Noted:
+ *      1) sits between search & update (data), writes are merged into
+ *          NUM_WCB lines (byte strobes), and drained to mm as a line write;
+ *      2) o_wr_finish is returned with the same latency as update, i.e.,
+ *          lsu still sees a fixed latency;
+ *      3) a read takes a snapshot of its line in buffer, and merges it into
+ *          the line returned by mm, i.e., buffered writes are forwarded;
+ *      4) a line is drained while mm port is idle, if it is full, not
+ *          written for TIMEOUT clks, or i_fence (mmio) is set; or it is
+ *          evicted by a write to a new line when all lines are in use;
+ *      5) snoop (dma, per word, a word is in the next line if winc): a dma
+ *          write clears the buffered bytes of the word (dma is newer), and
+ *          a dma read gets the buffered bytes by o_snoop_rdata/rstrb, with
+ *          the same latency as mm;
+ */
+
+module NanoCache_WCB #(
+  parameter BUFFER  = 1,
+  parameter NUM_WCB = 2,          //* 2^n, >= 2
+  parameter TIMEOUT = 8
+) (
+  //* clk & reset;
+  input   wire                        i_clk,
+  input   wire                        i_rst_n,
+
+  //* interface for search;
+  input   wire                        i_miss_rden,
+  input   wire                        i_miss_wren,
+  input   wire  [31:0]                i_miss_addr,      //* line addr
+  input   wire  [7:0][31:0]           i_miss_wdata,
+  input   wire  [7:0][ 3:0]           i_miss_wstrb,
+  output  wire                        o_upd_valid,
+  output  logic [7:0][31:0]           o_upd_rdata,
+  output  wire                        o_wr_finish,
+
+  //* interface for update;
+  output  wire                        o_miss_rden,
+  output  wire                        o_miss_wren,
+  output  wire  [31:0]                o_miss_addr,
+  output  wire  [7:0][31:0]           o_miss_wdata,
+  output  wire  [7:0][ 3:0]           o_miss_wstrb,
+  input   wire                        i_upd_valid,
+  input   wire  [7:0][31:0]           i_upd_rdata,
+
+  //* mmio fence, drain all lines;
+  input   wire                        i_fence,
+  output  wire                        o_empty,
+
+  //* snoop of dma;
+  input   wire                        i_snoop_rden,
+  input   wire                        i_snoop_wren,
+  input   wire  [31:0]                i_snoop_addr,     //* line addr
+  input   wire  [7:0]                 i_snoop_wstrb,    //* word strobe of dma write
+  input   wire  [7:0]                 i_snoop_winc,     //* the word is in the next line
+  output  wire  [7:0][31:0]           o_snoop_rdata,
+  output  wire  [7:0][ 3:0]           o_snoop_rstrb
+);
+  //====================================================================//
+  //*   internal reg/wire/param declarations
+  //====================================================================//
+  localparam WCB_BITS = $clog2(NUM_WCB);
+  localparam AGE_BITS = $clog2(TIMEOUT+1);
+
+  reg   [NUM_WCB-1:0]                 r_wcb_v;
+  reg   [NUM_WCB-1:0][26:0]           r_wcb_line;
+  reg   [NUM_WCB-1:0][7:0][31:0]      r_wcb_data;
+  reg   [NUM_WCB-1:0][7:0][ 3:0]      r_wcb_strb;
+  reg   [NUM_WCB-1:0][AGE_BITS-1:0]   r_wcb_age;
+  reg   [WCB_BITS-1:0]                r_vic;
+  logic [NUM_WCB-1:0]                 w_hit;
+  logic [WCB_BITS-1:0]                w_hit_id, w_free_id, w_drain_id, w_sel_id;
+  logic                               w_free_v, w_sel_v;
+  wire                                w_wr, w_evict, w_drain;
+  //* snapshot of the line read, returned with i_upd_valid;
+  reg   [1:0][7:0][31:0]              r_rd_data;
+  reg   [1:0][7:0][ 3:0]              r_rd_strb;
+  wire  [7:0][31:0]                   w_rd_data = BUFFER? r_rd_data[1]: r_rd_data[0];
+  wire  [7:0][ 3:0]                   w_rd_strb = BUFFER? r_rd_strb[1]: r_rd_strb[0];
+  reg   [1:0]                         r_wr_finish;
+  //* snoop;
+  logic [7:0][26:0]                   w_snoop_line;
+  logic [7:0][NUM_WCB-1:0]            w_snoop_hit;
+  logic [7:0][31:0]                   w_snoop_data;
+  logic [7:0][ 3:0]                   w_snoop_strb, w_drain_strb;
+  reg   [1:0][7:0][31:0]              r_snoop_data;
+  reg   [1:0][7:0][ 3:0]              r_snoop_strb;
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  //====================================================================//
+  //*   merge & drain
+  //====================================================================//
+  //* sc that fails (wstrb is '0) is not buffered;
+  assign w_wr         = i_miss_wren & (|i_miss_wstrb);
+  always_comb begin
+    w_hit_id          = '0;
+    w_free_v          = 1'b0;
+    w_free_id         = '0;
+    w_sel_v           = 1'b0;
+    w_sel_id          = '0;
+    for(integer e=NUM_WCB-1; e>=0; e=e-1) begin
+      w_hit[e]        = r_wcb_v[e] & (r_wcb_line[e] == i_miss_addr[26:0]);
+      if(w_hit[e])
+        w_hit_id      = e;
+      if(~r_wcb_v[e]) begin
+        w_free_v      = 1'b1;
+        w_free_id     = e;
+      end
+      //* the line written in this clk is not drained;
+      if(r_wcb_v[e] & ~(w_wr & w_hit[e]) &
+          (i_fence | (&r_wcb_strb[e]) | (r_wcb_age[e] == TIMEOUT))) begin
+        w_sel_v       = 1'b1;
+        w_sel_id      = e;
+      end
+    end
+  end
+  assign w_evict      = w_wr & ~(|w_hit) & ~w_free_v;
+  assign w_drain      = w_evict | w_sel_v & ~i_miss_rden;
+  assign w_drain_id   = w_evict? r_vic: w_sel_id;
+
+  assign o_miss_rden  = i_miss_rden;
+  assign o_miss_wren  = w_drain;
+  assign o_miss_addr  = w_drain? {5'b0,r_wcb_line[w_drain_id]}: i_miss_addr;
+  assign o_miss_wdata = r_wcb_data[w_drain_id];
+  assign o_miss_wstrb = w_drain_strb;
+  assign o_empty      = ~(|r_wcb_v);
+
+  //* snoop, the words written by dma are not drained in the same clk;
+  always_comb begin
+    w_snoop_data      = '0;
+    w_snoop_strb      = '0;
+    for(integer w=0; w<8; w=w+1) begin
+      w_snoop_line[w] = i_snoop_winc[w]? 27'(i_snoop_addr[26:0] + 1): i_snoop_addr[26:0];
+      for(integer e=0; e<NUM_WCB; e=e+1) begin
+        w_snoop_hit[w][e] = r_wcb_v[e] & (r_wcb_line[e] == w_snoop_line[w]);
+        if(w_snoop_hit[w][e] & i_snoop_rden) begin
+          w_snoop_data[w] = r_wcb_data[e][w];
+          w_snoop_strb[w] = r_wcb_strb[e][w];
+        end
+      end
+      w_drain_strb[w] = (i_snoop_wren & i_snoop_wstrb[w] & w_snoop_hit[w][w_drain_id])?
+                          4'b0: r_wcb_strb[w_drain_id][w];
+    end
+  end
+  assign o_snoop_rdata  = BUFFER? r_snoop_data[1]: r_snoop_data[0];
+  assign o_snoop_rstrb  = BUFFER? r_snoop_strb[1]: r_snoop_strb[0];
+
+  assign o_upd_valid  = i_upd_valid;
+  assign o_wr_finish  = BUFFER? r_wr_finish[1]: r_wr_finish[0];
+  always_comb begin
+    for(integer w=0; w<8; w=w+1)
+      for(integer b=0; b<4; b=b+1)
+        o_upd_rdata[w][b*8+:8] = w_rd_strb[w][b]? w_rd_data[w][b*8+:8]:
+                                                  i_upd_rdata[w][b*8+:8];
+  end
+  //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
+
+  always_ff @(posedge i_clk or negedge i_rst_n) begin
+    if (~i_rst_n) begin
+      r_wcb_v                   <= '0;
+      r_vic                     <= '0;
+      r_wr_finish               <= '0;
+    end else begin
+      r_wr_finish               <= {r_wr_finish[0], i_miss_wren};
+
+      for(integer e=0; e<NUM_WCB; e=e+1)
+        if(r_wcb_v[e] & (r_wcb_age[e] != TIMEOUT))
+          r_wcb_age[e]          <= r_wcb_age[e] + 1;
+      if(w_drain)
+        r_wcb_v[w_drain_id]     <= 1'b0;
+      //* dma write, before merging the write of search (newer) in this clk;
+      for(integer w=0; w<8; w=w+1)
+        for(integer e=0; e<NUM_WCB; e=e+1)
+          if(i_snoop_wren & i_snoop_wstrb[w] & w_snoop_hit[w][e])
+            r_wcb_strb[e][w]    <= 4'b0;
+
+      //* merge into the line, or allocate a free (or evicted) one;
+      if(w_wr & (|w_hit)) begin
+        r_wcb_age[w_hit_id]     <= '0;
+        for(integer w=0; w<8; w=w+1)
+          for(integer b=0; b<4; b=b+1)
+            if(i_miss_wstrb[w][b]) begin
+              r_wcb_strb[w_hit_id][w][b]        <= 1'b1;
+              r_wcb_data[w_hit_id][w][b*8+:8]   <= i_miss_wdata[w][b*8+:8];
+            end
+      end
+      else if(w_wr) begin
+        r_wcb_v[w_free_v? w_free_id: r_vic]     <= 1'b1;
+        r_wcb_line[w_free_v? w_free_id: r_vic]  <= i_miss_addr[26:0];
+        r_wcb_data[w_free_v? w_free_id: r_vic]  <= i_miss_wdata;
+        r_wcb_strb[w_free_v? w_free_id: r_vic]  <= i_miss_wstrb;
+        r_wcb_age[w_free_v? w_free_id: r_vic]   <= '0;
+        r_vic                   <= r_vic + 1;
+      end
+    end
+  end
+
+  //* snapshot, taken before the writes in the same clk (none, as search
+  //*   sends one access per clk);
+  always_ff @(posedge i_clk) begin
+    r_rd_data[0]                <= r_wcb_data[w_hit_id];
+    r_rd_strb[0]                <= (|w_hit)? r_wcb_strb[w_hit_id]: '0;
+    r_rd_data[1]                <= r_rd_data[0];
+    r_rd_strb[1]                <= r_rd_strb[0];
+    r_snoop_data                <= {r_snoop_data[0], w_snoop_data};
+    r_snoop_strb                <= {r_snoop_strb[0], w_snoop_strb};
+  end
+
+endmodule
@@ -25,12 +25,18 @@ module Memory_Top (
   input   wire  [          31:0]  i_data_addr  ,
   input   wire  [           3:0]  i_data_wstrb ,
   input   wire  [          31:0]  i_data_wdata ,
+  input   wire                    i_data_amo   ,  //* lr/sc/amo, with i_data_req/i_data_we
+  input   wire  [           4:0]  i_data_amo_op,
+  input   wire                    i_data_fence ,  //* drain buffered writes (mmio)
+  output  wire                    o_data_wcb_empty,
   output  wire                    o_data_valid ,
   output  wire  [          31:0]  o_data_rdata ,
   output  wire                    o_instr_gnt  ,
   input   wire                    i_instr_req  ,
   input   wire  [           1:0]  i_instr_req_2b,
   input   wire  [          31:0]  i_instr_addr ,
+  input   wire                    i_instr_prefetch_req,
+  input   wire  [          31:0]  i_instr_prefetch_addr,
   output  wire  [           1:0]  o_instr_valid,
   output  wire  [          63:0]  o_instr_rdata,
   //* interface for DMA;
@@ -43,6 +49,12 @@ module Memory_Top (
   output  logic [         255:0]  o_dma_rdata,
   output  wire                    o_dma_rvalid,
   output  wire                    o_dma_gnt
+`ifdef ENABLE_HPM
+  //* demand miss of instr/data cache, for hpm;
+  ,
+  output  wire                    o_miss_instr,
+  output  wire                    o_miss_data
+`endif
 );
   //====================================================================//
   //*   internal reg/wire/param declarations
@@ -61,6 +73,8 @@ module Memory_Top (
   wire  [ 7:0][       31:0]     w_mm_rdata_instr, w_mm_rdata_data;
   wire                          w_mm_rvalid_instr, w_mm_rvalid_data;
   reg   [ 7:0]                  temp_winc;
+  wire  [ 7:0][       31:0]     w_snoop_rdata;
+  wire  [ 7:0][        3:0]     w_snoop_rstrb;
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
   assign w_conf_dma_rden = {8{i_conf_rden | i_dma_rden}};
@@ -81,6 +95,11 @@ module Memory_Top (
   assign w_conf_dma_rdata_in128b[5] = w_conf_dma_rdata[5];
   assign w_conf_dma_rdata_in128b[6] = w_conf_dma_rdata[6];
   assign w_conf_dma_rdata_in128b[7] = w_conf_dma_rdata[7];
+  //* buffered bytes of data writes (not drained yet) are merged into dma rdata;
+  function automatic [31:0] merge_snoop(input [31:0] ram, input [31:0] wcb, input [3:0] strb);
+    for(integer b=0; b<4; b=b+1)
+      merge_snoop[b*8+:8] = strb[b]? wcb[b*8+:8]: ram[b*8+:8];
+  endfunction
   always_comb begin
     for(integer idx=0; idx <4; idx=idx+1) begin
         //* data conf & dma
@@ -90,7 +109,8 @@ module Memory_Top (
                                 i_dma_winc[idx]? (i_dma_addr + 16'd1):
                                                   i_dma_addr;
         w_conf_dma_wdata[idx]= i_conf_wren? i_conf_wdata[32*idx+:32]: i_dma_wdata[32*idx+:32];
-        o_dma_rdata[32*idx+:32]= w_conf_dma_rdata_in128b[idx];
+        o_dma_rdata[32*idx+:32]= merge_snoop(w_conf_dma_rdata_in128b[idx], w_snoop_rdata[idx],
+                                              w_snoop_rstrb[idx]);
         //* instr conf
         w_conf_wren_instr[idx] = i_conf_wren & ~i_conf_addr[2] & ~i_conf_addr[`MEM_TAG];
         w_conf_addr_instr[idx] = {19'b0,i_conf_addr[15:3]};
@@ -104,7 +124,8 @@ module Memory_Top (
                                 i_dma_winc[idx]? (i_dma_addr + 16'd1):
                                                   i_dma_addr;
         w_conf_dma_wdata[idx]= i_conf_wren? i_conf_wdata[32*(idx-4)+:32]: i_dma_wdata[32*idx+:32];
-        o_dma_rdata[32*idx+:32]= w_conf_dma_rdata_in128b[idx];
+        o_dma_rdata[32*idx+:32]= merge_snoop(w_conf_dma_rdata_in128b[idx], w_snoop_rdata[idx],
+                                              w_snoop_rstrb[idx]);
         //* instr conf
         w_conf_wren_instr[idx] = i_conf_wren & i_conf_addr[2] & ~i_conf_addr[`MEM_TAG];
         w_conf_addr_instr[idx] = {19'b0,i_conf_addr[15:3]};
@@ -130,12 +151,28 @@ module Memory_Top (
     .i_data_addr      (i_data_addr                ),
     .i_data_wstrb     (i_data_wstrb               ),
     .i_data_wdata     (i_data_wdata               ),
+    .i_data_amo       (i_data_amo                 ),
+    .i_data_amo_op    (i_data_amo_op              ),
+    //* dma writes break the reservation of lr;
+    .i_snoop_wren     (i_dma_wren                 ),
+    .i_snoop_addr     (i_dma_addr                 ),
+    .i_snoop_inc      (|i_dma_winc                ),
+    //* dma is coherent with buffered writes;
+    .i_snoop_rden     (i_dma_rden                 ),
+    .i_snoop_wstrb    (i_dma_wstrb                ),
+    .i_snoop_winc     (i_dma_winc                 ),
+    .o_snoop_rdata    (w_snoop_rdata              ),
+    .o_snoop_rstrb    (w_snoop_rstrb              ),
+    .i_data_fence     (i_data_fence               ),
+    .o_data_wcb_empty (o_data_wcb_empty           ),
     .o_data_valid     (o_data_valid               ),
     .o_data_rdata     (o_data_rdata               ),
     .o_instr_gnt      (o_instr_gnt                ),
     .i_instr_req      (i_instr_req                ),
     .i_instr_req_2b   (i_instr_req_2b             ),
     .i_instr_addr     (i_instr_addr               ),
+    .i_instr_prefetch_req (i_instr_prefetch_req   ),
+    .i_instr_prefetch_addr(i_instr_prefetch_addr  ),
     .o_instr_valid    (o_instr_valid              ),
     .o_instr_rdata    (o_instr_rdata              ),
 
@@ -154,6 +191,11 @@ module Memory_Top (
     .i_mm_rdata_data  (w_mm_rdata_data            ),
     .i_mm_rvalid_data (w_mm_rvalid_data           ),
     .i_mm_gnt_data    (1'b1                       )
+  `ifdef ENABLE_HPM
+    ,
+    .o_miss_instr     (o_miss_instr               ),
+    .o_miss_data      (o_miss_data                )
+  `endif
   );
 
   reg [1:0] temp_imm_rden_instr, temp_imm_rden_data, temp_dma_rden;
@@ -40,6 +40,10 @@ module Peri_Top(
   ,output wire  [        31:0]  o_irq    
   ,input  wire                  i_irq_ack
   ,input  wire  [         4:0]  i_irq_id 
+`ifdef ENABLE_HPM
+  //* hpm counters, mirrored in CSR;
+  ,input  wire  [(`HPM_NUM+2)*64-1:0] i_hpm_cnt
+`endif
 `ifdef UART_BY_PKT
   ,output wire                  o_uartPkt_valid
   ,output wire  [       133:0]  o_uartPkt
@@ -141,6 +145,9 @@ module Peri_Top(
     .o_dout_32b_valid   (w_ready_peri[`CSR]     ),
     .o_interrupt        (w_int_peri[`CSR]       ),
     .o_time_int         (w_time_int             )
+  `ifdef ENABLE_HPM
+    ,.i_hpm_cnt         (i_hpm_cnt              )
+  `endif
   );
   //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>//
 
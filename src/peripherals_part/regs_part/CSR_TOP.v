@@ -25,6 +25,10 @@ module CSR_TOP (
   //* interrupt;
   output  wire                o_interrupt,          
   output  reg                 o_time_int 
+`ifdef ENABLE_HPM
+  //* hpm counters of PE0, {mhpmcounter3~, instret, cycle}, read-only;
+  ,input  wire  [(`HPM_NUM+2)*64-1:0] i_hpm_cnt
+`endif
   // //* system time;
   // ,input  wire                i_update_valid
   // ,input  wire  [   64:0]     i_update_system_time
@@ -65,6 +69,16 @@ module CSR_TOP (
   //* guard;
     assign w_guard_en       = (r_guard == 16'h1234);
 
+  //* addr[7] is 1: mirror of hpm counters, word 0/1 is cycle, word 2/3 is
+  //*   instret, word 4/5 is mhpmcounter3, ...;
+  wire          [31:0]      w_hpm_rdata;
+  `ifdef ENABLE_HPM
+    assign w_hpm_rdata      = (i_addr_32b[6:2] < 2*(`HPM_NUM+2))? 
+                                i_hpm_cnt[i_addr_32b[6:2]*32+:32]: 32'b0;
+  `else
+    assign w_hpm_rdata      = 32'b0;
+  `endif
+
   //==============================================================//
   //  time interrupt    
   //==============================================================//
@@ -110,8 +124,8 @@ module CSR_TOP (
       r_toUpdate_time               <= 1'b0;
       r_intTime_en                  <= 'b0;
 
-      //* writing;
-      if(i_wren) begin
+      //* writing, hpm mirror is read-only;
+      if(i_wren & ~i_addr_32b[7]) begin
         r_guard                     <= 16'b0;
         case(i_addr_32b[6:2])
           5'd0: begin   end
@@ -154,7 +168,9 @@ module CSR_TOP (
       end
 
       //* to read;
-      if(i_rden == 1'b1) begin
+      if(i_rden == 1'b1 && i_addr_32b[7] == 1'b1)
+        o_dout_32b                  <= w_hpm_rdata;
+      else if(i_rden == 1'b1) begin
         (*full_case, parallel_case*)
         case(i_addr_32b[2+:5])
           5'd0: o_dout_32b          <= 32'b0;